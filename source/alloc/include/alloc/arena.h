@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace alloc
+{
+    //hands out memory by bumping an offset through a block, and frees everything at once on reset
+    //allocating costs a few instructions and nothing is freed one at a time, so it suits buffers that only live for a frame
+    //allocations that don't fit are taken from the heap, and the next reset grows the block to the peak so they fit from then on
+    //not thread safe, allocate from one thread at a time
+    class Arena
+    {
+    public:
+        explicit Arena(size_t capacity);
+        ~Arena();
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        //only the most recent allocation is given back, so a vector growing at the end of the arena reuses its old buffer
+        //anything else is freed by reset
+        void deallocate(void* pointer, size_t size);
+        //uninitialised storage for count values
+        template<typename T>
+        std::span<T> allocate_array(size_t count);
+        //frees every allocation
+        void reset();
+
+        //bytes allocated since the last reset, including any taken from the heap
+        size_t used() const { return m_offset + m_overflow_bytes; }
+        size_t capacity() const { return m_capacity; }
+        //most bytes allocated between resets
+        size_t peak_usage() const;
+        //allocations that didn't fit since the last reset
+        int overflow_count() const { return (int)m_overflow.size(); }
+
+    private:
+        struct Overflow
+        {
+            void* pointer;
+            size_t alignment;
+        };
+
+        std::byte* m_block = nullptr;
+        size_t m_capacity = 0;
+        size_t m_offset = 0;
+        std::vector<Overflow> m_overflow;
+        size_t m_overflow_bytes = 0;
+        size_t m_peak = 0;
+    };
+
+    //a pair of arenas used on alternate frames, so a frame's allocations stay valid until the end of the next one
+    //for data that is still read a frame later, like buffers the gpu is drawing from or results of jobs started last frame
+    class FrameArena
+    {
+    public:
+        explicit FrameArena(size_t capacity_per_frame);
+
+        //resets the arena used the frame before last and makes it current
+        void begin_frame();
+        Arena& current() { return m_arenas[m_current]; }
+        Arena& previous() { return m_arenas[1 - m_current]; }
+        //most bytes used by a single frame
+        size_t peak_usage() const;
+
+    private:
+        Arena m_arenas[2];
+        int m_current = 0;
+    };
+
+    //lets standard containers allocate from an arena, deallocation does nothing unless it is the arena's most recent allocation
+    //containers must not outlive the arena's next reset
+    template<typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+        T* allocate(size_t count);
+        void deallocate(T* pointer, size_t count);
+        Arena* arena() const { return m_arena; }
+
+    private:
+        Arena* m_arena;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs);
+
+    //a vector for a frame's transient data, reserve up front as growing leaves the old buffers in the arena until the reset
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
+
+//inline definitions
+namespace alloc
+{
+    template<typename T>
+    std::span<T> Arena::allocate_array(size_t count)
+    {
+        return { static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count };
+    }
+
+    template<typename T>
+    T* ArenaAllocator<T>::allocate(size_t count)
+    {
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template<typename T>
+    void ArenaAllocator<T>::deallocate(T* pointer, size_t count)
+    {
+        m_arena->deallocate(pointer, count * sizeof(T));
+    }
+
+    template<typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+    {
+        return lhs.arena() == rhs.arena();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace alloc
+{
+    Arena::Arena(size_t capacity)
+        : m_block(static_cast<std::byte*>(::operator new(capacity, std::align_val_t(alignof(std::max_align_t)))))
+        , m_capacity(capacity)
+    {}
+
+    Arena::~Arena()
+    {
+        reset();
+        ::operator delete(m_block, std::align_val_t(alignof(std::max_align_t)));
+    }
+
+    void* Arena::allocate(size_t size, size_t alignment)
+    {
+        _ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+        uintptr_t address = reinterpret_cast<uintptr_t>(m_block) + m_offset;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + size <= m_capacity)
+        {
+            void* pointer = m_block + m_offset + padding;
+            m_offset += padding + size;
+            return pointer;
+        }
+
+        //the slow path, only until the next reset grows the block
+        void* pointer = ::operator new(size, std::align_val_t(std::max(alignment, alignof(std::max_align_t))));
+        m_overflow.push_back({ pointer, std::max(alignment, alignof(std::max_align_t)) });
+        m_overflow_bytes += size;
+        return pointer;
+    }
+
+    void Arena::deallocate(void* pointer, size_t size)
+    {
+        std::byte* end = static_cast<std::byte*>(pointer) + size;
+        if (end == m_block + m_offset)
+        {
+            m_offset -= size;
+        }
+    }
+
+    void Arena::reset()
+    {
+        m_peak = std::max(m_peak, used());
+        if (!m_overflow.empty())
+        {
+            for (const Overflow& overflow : m_overflow)
+            {
+                ::operator delete(overflow.pointer, std::align_val_t(overflow.alignment));
+            }
+            m_overflow.clear();
+
+            //room for the peak with some slack for alignment, so the next frame like this one fits in the block
+            ::operator delete(m_block, std::align_val_t(alignof(std::max_align_t)));
+            m_capacity = std::max(m_capacity * 2, m_peak + m_peak / 8);
+            m_block = static_cast<std::byte*>(::operator new(m_capacity, std::align_val_t(alignof(std::max_align_t))));
+        }
+        m_offset = 0;
+        m_overflow_bytes = 0;
+    }
+
+    size_t Arena::peak_usage() const
+    {
+        return std::max(m_peak, used());
+    }
+
+    FrameArena::FrameArena(size_t capacity_per_frame)
+        : m_arenas{ Arena(capacity_per_frame), Arena(capacity_per_frame) }
+    {}
+
+    void FrameArena::begin_frame()
+    {
+        m_current = 1 - m_current;
+        m_arenas[m_current].reset();
+    }
+
+    size_t FrameArena::peak_usage() const
+    {
+        return std::max(m_arenas[0].peak_usage(), m_arenas[1].peak_usage());
+    }
+}
\ No newline at end of file
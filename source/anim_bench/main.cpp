@@ -0,0 +1,1167 @@
+#include "bench/bench.h"
+
+#include "alloc/arena.h"
+
+#include "animation/animation.h"
+#include "animation/batch.h"
+#include "animation/blob.h"
+#include "animation/blend.h"
+#include "animation/compressed_animation.h"
+#include "animation/lod.h"
+#include "animation/curve_animation.h"
+#include "animation/pose.h"
+#include "animation/retarget.h"
+#include "animation/sampling_cache.h"
+#include "animation/skeleton.h"
+
+#include "file/binary_serializer.h"
+#include "file/mapped_file.h"
+
+#include "maths/geometry.h"
+
+#include "jobs/job_system.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+//every heap allocation in the program is counted so the steady state frame can be checked for allocations
+//each form of new is replaced along with the deletes that release it, so no delete frees memory from an allocator it doesn't match
+namespace
+{
+    std::atomic<long long> g_allocation_count = 0;
+
+    void* counted_allocate(size_t size, size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ++g_allocation_count;
+        size = size == 0 ? 1 : size;
+#if defined(_MSC_VER)
+        void* pointer = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? _aligned_malloc(size, alignment) : malloc(size);
+#else
+        //aligned_alloc needs the size to be a multiple of the alignment
+        void* pointer = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1)) : malloc(size);
+#endif
+        if (pointer == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+    void counted_free(void* pointer, size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+#if defined(_MSC_VER)
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            _aligned_free(pointer);
+            return;
+        }
+#endif
+        (void)alignment;
+        free(pointer);
+    }
+}
+
+void* operator new(size_t size) { return counted_allocate(size); }
+void* operator new[](size_t size) { return counted_allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return counted_allocate(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return counted_allocate(size, (size_t)alignment); }
+
+void operator delete(void* pointer) noexcept { counted_free(pointer); }
+void operator delete[](void* pointer) noexcept { counted_free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { counted_free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { counted_free(pointer); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { counted_free(pointer, (size_t)alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { counted_free(pointer, (size_t)alignment); }
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept { counted_free(pointer, (size_t)alignment); }
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept { counted_free(pointer, (size_t)alignment); }
+
+namespace
+{
+    //sizes roughly matching a crowd in the launch app, bones per skeleton is limited by the skinning shader
+    constexpr int g_bone_count = 100;
+    constexpr int g_instance_count = 1000;
+    //a one second clip sampled at 30 frames per second, as exported from the fbx files
+    constexpr int g_key_frame_count = 31;
+    constexpr float g_key_frame_interval = 1.f / 30.f;
+    //a one minute clip, to check sampling cost doesn't grow with clip length
+    constexpr int g_long_key_frame_count = 1801;
+    //a scene with thousands of characters, for batch evaluation across threads
+    constexpr int g_batch_instance_count = 5000;
+
+    std::mt19937 g_random(12345);
+
+    float random_float(float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(g_random);
+    }
+
+    anim::Transform random_transform()
+    {
+        geom::Quaternion rotation = { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) };
+        return { { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) }, rotation.normalized() };
+    }
+
+    //each bone's parent is a random earlier bone, as the importer guarantees parents come first
+    anim::Skeleton create_skeleton()
+    {
+        anim::Skeleton skeleton;
+        skeleton.name = "bench";
+        skeleton.bones.resize(g_bone_count);
+        for (int i = 0; i < g_bone_count; ++i)
+        {
+            skeleton.bones[i].parent_index = i == 0 ? -1 : std::uniform_int_distribution<int>(0, i - 1)(g_random);
+            skeleton.bones[i].global_transform = random_transform();
+        }
+        skeleton.update_hierarchy();
+        return skeleton;
+    }
+
+    anim::Pose create_pose(const anim::Skeleton& skeleton)
+    {
+        anim::Pose pose;
+        pose.skeleton = &skeleton;
+        pose.local_transforms.resize(skeleton.bones.size());
+        for (auto& transform : pose.local_transforms)
+        {
+            transform = random_transform();
+        }
+        return pose;
+    }
+
+    //a clip with motion like a character's rather than random poses, so there is something for compression to find
+    //bones are around 10 units long with smooth rotations about their rest pose, some are still and the root moves
+    anim::Animation create_smooth_clip(const anim::Skeleton& skeleton, int key_frame_count)
+    {
+        struct BoneMotion
+        {
+            anim::Transform rest;
+            geom::Vector3 axis;
+            float amplitude;
+            float frequency;
+            float phase;
+        };
+        std::vector<BoneMotion> motions(skeleton.bones.size());
+        for (auto& motion : motions)
+        {
+            float still = random_float(0.f, 1.f);
+            geom::Quaternion rest_rotation = { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) };
+            motion.rest = {
+                geom::Vector3{ random_float(-1.f, 1.f), random_float(2.f, 3.f), random_float(-1.f, 1.f) } * 4.f,
+                still < 0.1f ? geom::Quaternion::identity() : rest_rotation.normalized()
+            };
+            motion.axis = geom::Vector3{ random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) }.normalized();
+            motion.amplitude = still < 0.3f ? 0.f : random_float(0.05f, 0.5f);
+            motion.frequency = random_float(0.25f, 1.f);
+            motion.phase = random_float(0.f, 2.f * geom::PI);
+        }
+
+        anim::Animation animation(skeleton);
+        animation.reserve(key_frame_count, (int)skeleton.bones.size());
+        anim::Pose pose;
+        pose.skeleton = &skeleton;
+        pose.local_transforms.resize(skeleton.bones.size());
+        for (int i = 0; i < key_frame_count; ++i)
+        {
+            float time = i * g_key_frame_interval;
+            for (int bone = 0; bone < (int)motions.size(); ++bone)
+            {
+                const BoneMotion& motion = motions[bone];
+                float half_angle = 0.5f * motion.amplitude * sinf(2.f * geom::PI * motion.frequency * time + motion.phase);
+                geom::Vector3 axis = motion.axis * sinf(half_angle);
+                pose.local_transforms[bone] = { motion.rest.translation, motion.rest.rotation * geom::Quaternion{ axis.x, axis.y, axis.z, cosf(half_angle) } };
+            }
+            pose.local_transforms[0].translation = { 100.f * sinf(0.5f * time), 0.f, 150.f * time };
+            animation.add_keyframe(pose, time);
+        }
+        return animation;
+    }
+
+    //the matrix stack as it was calculated before transforms were composed directly, used as the baseline
+    std::vector<geom::Matrix44> matrix_stack_by_matrices(const anim::Pose& pose)
+    {
+        auto local_matrix = [](const anim::Transform& transform)
+        {
+            return geom::create_translation_matrix_44(transform.translation) * geom::create_rotation_matrix_from_quaternion(transform.rotation);
+        };
+
+        std::vector<geom::Matrix44> stack;
+        stack.resize(pose.local_transforms.size());
+        stack[0] = local_matrix(pose.local_transforms[0]);
+        for (int i = 1; i < (int)pose.local_transforms.size(); ++i)
+        {
+            stack[i] = stack[pose.skeleton->bones[i].parent_index] * local_matrix(pose.local_transforms[i]);
+        }
+        return stack;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::parse_options(argc, argv);
+    bench::Report report;
+    report.context["instruction_set"] = geom::simd::instruction_set();
+
+    anim::Skeleton skeleton = create_skeleton();
+    std::vector<anim::Pose> poses;
+    for (int i = 0; i < g_instance_count; ++i)
+    {
+        poses.push_back(create_pose(skeleton));
+    }
+
+    //composing transforms should give the same result as multiplying matrices
+    float max_error = 0.f;
+    for (auto& pose : poses)
+    {
+        auto expected = matrix_stack_by_matrices(pose);
+        auto actual = pose.get_matrix_stack();
+        for (int bone = 0; bone < g_bone_count; ++bone)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                max_error = fmaxf(max_error, fabsf(expected[bone].values[i] - actual[bone].values[i]));
+            }
+        }
+    }
+    std::cout << "matrix stack max error vs matrix path: " << max_error << "\n";
+
+    auto by_matrices = bench::run("matrix_stack_by_matrices", 10, [&]()
+        {
+            for (auto& pose : poses)
+            {
+                bench::do_not_optimise(matrix_stack_by_matrices(pose));
+            }
+        });
+    auto by_transforms = bench::run("matrix_stack", 10, [&]()
+        {
+            for (auto& pose : poses)
+            {
+                bench::do_not_optimise(pose.get_matrix_stack());
+            }
+        });
+    auto affine = bench::run("affine_matrix_stack", 10, [&]()
+        {
+            for (auto& pose : poses)
+            {
+                bench::do_not_optimise(pose.get_affine_matrix_stack());
+            }
+        });
+    report.add(by_matrices);
+    report.add(by_transforms);
+    report.add(affine);
+    bench::print_speedup(by_matrices, by_transforms);
+    bench::print_speedup(by_matrices, affine);
+
+    //walking the hierarchy through the bones, through the compact parent array, and a depth level at a time after breadth first ordering
+    {
+        const anim::Skeleton& indexed = skeleton;
+        //the walk falls back to the bones without the compact arrays
+        anim::Skeleton unindexed = skeleton;
+        unindexed.parents.clear();
+        unindexed.depth_levels.clear();
+        anim::Skeleton breadth_first = skeleton;
+        std::vector<int> remap = anim::reorder_bones(breadth_first, anim::BoneOrder::BreadthFirst);
+        std::vector<anim::Pose> reordered_poses = poses;
+        for (size_t i = 0; i < poses.size(); ++i)
+        {
+            reordered_poses[i].skeleton = &breadth_first;
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                reordered_poses[i].local_transforms[remap[bone]] = poses[i].local_transforms[bone];
+            }
+        }
+        std::cout << "breadth first skeleton has " << breadth_first.depth_levels.size() << " depth levels\n";
+
+        //reordering only moves the bones, so each bone's global transform should be unchanged
+        std::vector<anim::Transform> globals(g_bone_count);
+        std::vector<anim::Transform> reordered_globals(g_bone_count);
+        float reorder_error = 0.f;
+        for (size_t i = 0; i < poses.size(); ++i)
+        {
+            anim::calculate_global_transforms(skeleton, poses[i].local_transforms, globals);
+            anim::calculate_global_transforms(breadth_first, reordered_poses[i].local_transforms, reordered_globals);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                const anim::Transform& expected = globals[bone];
+                const anim::Transform& actual = reordered_globals[remap[bone]];
+                reorder_error = fmaxf(reorder_error, (expected.translation - actual.translation).magnitude());
+                reorder_error = fmaxf(reorder_error, 1.f - fabsf(geom::Quaternion::dot(expected.rotation, actual.rotation)));
+            }
+        }
+        std::cout << "breadth first global transforms max error: " << reorder_error << "\n";
+
+        auto walk = [&](const char* name, const anim::Skeleton& walked, const std::vector<anim::Pose>& walked_poses)
+        {
+            return bench::run(name, 10, [&]()
+                {
+                    for (auto& pose : walked_poses)
+                    {
+                        anim::calculate_global_transforms(walked, pose.local_transforms, globals);
+                        bench::do_not_optimise(globals.back());
+                    }
+                });
+        };
+        auto by_bones = walk("global_transforms_bones", unindexed, poses);
+        auto by_parents = walk("global_transforms_parent_array", indexed, poses);
+        auto by_levels = walk("global_transforms_depth_levels", breadth_first, reordered_poses);
+        report.add(by_bones);
+        report.add(by_parents);
+        report.add(by_levels);
+        bench::print_speedup(by_bones, by_parents);
+        bench::print_speedup(by_bones, by_levels);
+    }
+
+    //the skinning palette, the shader used to take the pose's matrix stack and the inverse bind matrices and multiply them per vertex
+    //the combined palette is the same work on the cpu as multiplying the stack by the inverse bind matrices, so this only checks it
+    //adds nothing, the saving is the halved upload and the shader's one matrix per vertex
+    {
+        std::vector<anim::Transform> globals(g_bone_count);
+        std::vector<geom::Matrix44> stack(g_bone_count);
+        std::vector<geom::Matrix44> palette(g_bone_count);
+        float palette_error = 0.f;
+        for (auto& pose : poses)
+        {
+            pose.get_matrix_stack(stack, globals);
+            anim::calculate_skinning_matrices(skeleton, globals, palette);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                geom::Matrix44 expected = stack[bone] * skeleton.inv_matrix_stack[bone];
+                for (int i = 0; i < 16; ++i)
+                {
+                    palette_error = fmaxf(palette_error, fabsf(expected.values[i] - palette[bone].values[i]));
+                }
+            }
+        }
+        std::cout << "skinning palette max error vs matrix stack times inverse bind: " << palette_error
+            << ", uploaded per instance " << 2 * g_bone_count * sizeof(geom::Matrix44) << " -> " << g_bone_count * sizeof(geom::Matrix44) << " bytes\n";
+
+        auto by_matrices = bench::run("skinning_palette_by_matrices", 10, [&]()
+            {
+                for (auto& pose : poses)
+                {
+                    pose.get_matrix_stack(stack, globals);
+                    for (int bone = 0; bone < g_bone_count; ++bone)
+                    {
+                        palette[bone] = stack[bone] * skeleton.inv_matrix_stack[bone];
+                    }
+                    bench::do_not_optimise(palette.back());
+                }
+            });
+        auto by_transforms = bench::run("skinning_palette", 10, [&]()
+            {
+                for (auto& pose : poses)
+                {
+                    pose.get_global_transforms(globals);
+                    anim::calculate_skinning_matrices(skeleton, globals, palette);
+                    bench::do_not_optimise(palette.back());
+                }
+            });
+        report.add(by_matrices);
+        report.add(by_transforms);
+        bench::print_speedup(by_matrices, by_transforms);
+    }
+
+    //sampling a clip, each instance is at a different time as in the launch app
+    anim::Animation animation(skeleton);
+    for (int i = 0; i < g_key_frame_count; ++i)
+    {
+        animation.add_keyframe(create_pose(skeleton), i * g_key_frame_interval);
+    }
+    std::vector<float> times(g_instance_count);
+    for (float& time : times)
+    {
+        time = random_float(0.f, 10.f);
+    }
+
+    const char* method_names[] = { "slerp", "fast_slerp", "corrected_nlerp", "nlerp" };
+    geom::RotationInterpolation methods[] = {
+        geom::RotationInterpolation::Slerp,
+        geom::RotationInterpolation::FastSlerp,
+        geom::RotationInterpolation::CorrectedNlerp,
+        geom::RotationInterpolation::Nlerp
+    };
+    std::vector<bench::Result> get_pose_results;
+    for (int method = 0; method < 4; ++method)
+    {
+        animation.set_rotation_interpolation(methods[method]);
+        get_pose_results.push_back(bench::run(std::string("get_pose_") + method_names[method], 10, [&]()
+            {
+                for (float time : times)
+                {
+                    bench::do_not_optimise(animation.get_pose(time, true));
+                }
+            }));
+        report.add(get_pose_results.back());
+    }
+    for (int method = 1; method < 4; ++method)
+    {
+        bench::print_speedup(get_pose_results[0], get_pose_results[method]);
+    }
+
+    //the whole per frame update of the crowd, sample then build the matrix stack for skinning
+    animation.set_rotation_interpolation(geom::RotationInterpolation::Slerp);
+    auto frame = bench::run("crowd_frame_update", 10, [&]()
+        {
+            for (float time : times)
+            {
+                bench::do_not_optimise(animation.get_pose(time, true).get_matrix_stack());
+            }
+        });
+    report.add(frame);
+
+    //the same update into buffers that are reused across instances and frames, as the launch app does
+    anim::PlaybackCursor cursor;
+    anim::Pose pose;
+    pose.skeleton = &skeleton;
+    pose.local_transforms.resize(g_bone_count);
+    std::vector<anim::Transform> global_transforms(g_bone_count);
+    std::vector<geom::Matrix44> matrix_stack(g_bone_count);
+    auto update_into_buffers = [&]()
+    {
+        for (float time : times)
+        {
+            animation.get_pose(time, cursor, pose.local_transforms, true);
+            pose.get_matrix_stack(matrix_stack, global_transforms);
+            bench::do_not_optimise(matrix_stack.back());
+        }
+    };
+    auto frame_into_buffers = bench::run("crowd_frame_update_into_buffers", 10, update_into_buffers);
+    report.add(frame_into_buffers);
+    bench::print_speedup(frame, frame_into_buffers);
+
+    long long allocations_before = g_allocation_count;
+    for (float time : times)
+    {
+        bench::do_not_optimise(animation.get_pose(time, true).get_matrix_stack());
+    }
+    long long returned_allocations = g_allocation_count - allocations_before;
+
+    allocations_before = g_allocation_count;
+    update_into_buffers();
+    long long frame_allocations = g_allocation_count - allocations_before;
+    std::cout << "heap allocations in a steady state crowd frame: " << frame_allocations
+        << ", " << returned_allocations << " when returning poses and matrix stacks by value\n";
+
+    //buffers that only live for a frame, every instance's palette kept until the frame is drawn, from the heap against a frame arena
+    {
+        auto heap_frame = [&]()
+        {
+            std::vector<std::vector<geom::Matrix44>> palettes(g_instance_count);
+            std::vector<anim::Transform> globals(g_bone_count);
+            for (int i = 0; i < g_instance_count; ++i)
+            {
+                palettes[i].resize(g_bone_count);
+                animation.get_pose(times[i], pose.local_transforms, true);
+                anim::calculate_global_transforms(skeleton, pose.local_transforms, globals);
+                anim::calculate_skinning_matrices(skeleton, globals, palettes[i]);
+            }
+            bench::do_not_optimise(palettes.back().back());
+        };
+        //starts small so the first frames overflow and the arena grows to fit
+        alloc::FrameArena frame_arena(4096);
+        auto arena_frame = [&]()
+        {
+            frame_arena.begin_frame();
+            alloc::Arena& arena = frame_arena.current();
+            auto palettes = arena.allocate_array<std::span<geom::Matrix44>>(g_instance_count);
+            auto globals = arena.allocate_array<anim::Transform>(g_bone_count);
+            for (int i = 0; i < g_instance_count; ++i)
+            {
+                palettes[i] = arena.allocate_array<geom::Matrix44>(g_bone_count);
+                animation.get_pose(times[i], pose.local_transforms, true);
+                anim::calculate_global_transforms(skeleton, pose.local_transforms, globals);
+                anim::calculate_skinning_matrices(skeleton, globals, palettes[i]);
+            }
+            bench::do_not_optimise(palettes.back().back());
+        };
+        auto heap_result = bench::run("frame_buffers_heap", 10, heap_frame);
+        auto arena_result = bench::run("frame_buffers_arena", 10, arena_frame);
+        report.add(heap_result);
+        report.add(arena_result);
+        bench::print_speedup(heap_result, arena_result);
+
+        allocations_before = g_allocation_count;
+        heap_frame();
+        long long heap_allocations = g_allocation_count - allocations_before;
+        allocations_before = g_allocation_count;
+        arena_frame();
+        long long arena_allocations = g_allocation_count - allocations_before;
+        std::cout << "heap allocations in a frame of transient buffers: " << arena_allocations << " from the frame arena, " << heap_allocations
+            << " from the heap, arena peak " << frame_arena.peak_usage() << " bytes\n";
+    }
+
+    //keyframe lookup, uniform clips index directly, others binary search, cursors skip the lookup during forward playback
+    //the long clips share a handful of poses as only the number of keyframes matters here
+    std::vector<anim::Pose> shared_poses;
+    for (int i = 0; i < 4; ++i)
+    {
+        shared_poses.push_back(create_pose(skeleton));
+    }
+    anim::Animation long_uniform(skeleton);
+    anim::Animation long_non_uniform(skeleton);
+    long_uniform.reserve(g_long_key_frame_count, g_bone_count);
+    long_non_uniform.reserve(g_long_key_frame_count, g_bone_count);
+    for (int i = 0; i < g_long_key_frame_count; ++i)
+    {
+        long_uniform.add_keyframe(shared_poses[i % 4], i * g_key_frame_interval);
+        long_non_uniform.add_keyframe(shared_poses[i % 4], (i + random_float(0.f, 0.5f)) * g_key_frame_interval);
+    }
+    std::cout << "key interval of uniform clip " << long_uniform.key_interval() << ", non uniform clip " << long_non_uniform.key_interval() << "\n";
+
+    //keyframe memory against the previous layout of a separately allocated pose per keyframe, not counting allocator overhead
+    size_t pose_per_key_frame_bytes = g_long_key_frame_count * (sizeof(anim::Pose) + sizeof(float) + g_bone_count * sizeof(anim::Transform));
+    std::cout << "long clip keyframe memory: " << long_uniform.memory_usage() << " bytes in 2 allocations, "
+        << pose_per_key_frame_bytes << " bytes in " << g_long_key_frame_count + 1 << " allocations as a pose per keyframe\n";
+
+    auto sample_clip = [&](const char* name, const anim::Animation& clip)
+    {
+        for (float& time : times)
+        {
+            time = random_float(0.f, clip.duration());
+        }
+        report.add(bench::run(std::string("get_pose_") + name, 10, [&]()
+            {
+                for (float time : times)
+                {
+                    bench::do_not_optimise(clip.get_pose(time, true));
+                }
+            }));
+
+        //each instance plays forward at 60 frames per second from a random start
+        std::vector<anim::PlaybackCursor> cursors(g_instance_count);
+        report.add(bench::run(std::string("get_pose_cursor_") + name, 10, [&]()
+            {
+                for (int i = 0; i < g_instance_count; ++i)
+                {
+                    times[i] += 1.f / 60.f;
+                    bench::do_not_optimise(clip.get_pose(times[i], cursors[i], true));
+                }
+            }));
+    };
+    sample_clip("short_uniform", animation);
+    sample_clip("long_uniform", long_uniform);
+    sample_clip("long_non_uniform", long_non_uniform);
+
+    //native files, reading a skeleton and a long clip back in blocks against a value at a time into poses as a pose per keyframe format would
+    {
+        auto path = std::filesystem::temp_directory_path() / "anim_bench_clip.bin";
+        {
+            std::ofstream stream = file::open_for_write_binary(path);
+            stream << skeleton << long_uniform;
+        }
+
+        auto block_result = bench::run("native_clip_read", 10, [&]()
+            {
+                std::ifstream stream = file::open_for_read_binary(path);
+                anim::Skeleton read_skeleton;
+                anim::Animation read_clip(skeleton);
+                stream >> read_skeleton >> read_clip;
+                bench::do_not_optimise(read_clip.key_frame_count());
+            });
+        auto per_value_result = bench::run("native_clip_read_per_value", 10, [&]()
+            {
+                std::ifstream stream = file::open_for_read_binary(path);
+                anim::Skeleton read_skeleton;
+                stream >> read_skeleton;
+                int bone_count, key_frame_count;
+                geom::RotationInterpolation interpolation;
+                stream >> bone_count >> key_frame_count >> interpolation;
+                std::vector<float> key_times(key_frame_count);
+                std::vector<anim::Pose> poses(key_frame_count, anim::Pose{ &skeleton, std::vector<anim::Transform>(g_bone_count) });
+                for (float& time : key_times)
+                {
+                    stream >> time;
+                }
+                for (anim::Pose& key_pose : poses)
+                {
+                    for (anim::Transform& transform : key_pose.local_transforms)
+                    {
+                        stream >> transform.translation;
+                    }
+                }
+                for (anim::Pose& key_pose : poses)
+                {
+                    for (anim::Transform& transform : key_pose.local_transforms)
+                    {
+                        stream >> transform.rotation;
+                    }
+                }
+                anim::Animation read_clip(skeleton);
+                for (int i = 0; i < key_frame_count; ++i)
+                {
+                    read_clip.add_keyframe(poses[i], key_times[i]);
+                }
+                bench::do_not_optimise(read_clip.key_frame_count());
+            });
+        report.add(per_value_result);
+        report.add(block_result);
+        bench::print_speedup(per_value_result, block_result);
+
+        std::ifstream stream = file::open_for_read_binary(path);
+        anim::Skeleton read_skeleton;
+        anim::Animation read_clip(skeleton);
+        stream >> read_skeleton >> read_clip;
+        bool matches = anim::Skeleton::equivalent(skeleton, read_skeleton)
+            && read_clip.key_frame_count() == long_uniform.key_frame_count()
+            && read_clip.key_interval() == long_uniform.key_interval();
+        for (int key_frame = 0; matches && key_frame < read_clip.key_frame_count(); ++key_frame)
+        {
+            auto translations = read_clip.key_frame_translations(key_frame);
+            auto rotations = read_clip.key_frame_rotations(key_frame);
+            matches = read_clip.key_times()[key_frame] == long_uniform.key_times()[key_frame]
+                && std::equal(translations.begin(), translations.end(), long_uniform.key_frame_translations(key_frame).begin())
+                && std::equal(rotations.begin(), rotations.end(), long_uniform.key_frame_rotations(key_frame).begin());
+        }
+        std::cout << "native clip file: " << std::filesystem::file_size(path) << " bytes, read back " << (matches ? "exactly" : "with differences") << "\n";
+        stream.close();
+        std::filesystem::remove(path);
+
+        //the same skeleton and clip as a blob, mapped and sampled in place rather than read into allocations
+        constexpr file::FileHeader blob_header = { file::make_tag("BNCH"), 1 };
+        struct BenchBlob
+        {
+            anim::SkeletonBlob skeleton;
+            anim::ClipBlob clip;
+        };
+        auto blob_path = std::filesystem::temp_directory_path() / "anim_bench_clip.blob";
+        {
+            file::BlobWriter writer(blob_header);
+            BenchBlob root = { anim::add_skeleton(writer, skeleton), anim::add_clip(writer, long_uniform, "long_uniform") };
+            writer.set_root(root);
+            writer.save(blob_path);
+        }
+
+        auto map_result = bench::run("native_clip_map", 10, [&]()
+            {
+                file::MappedFile mapped(blob_path);
+                file::BlobView view(mapped.bytes(), blob_header);
+                const BenchBlob* root = view.root<BenchBlob>();
+                anim::Skeleton mapped_skeleton;
+                anim::read_skeleton(view, root->skeleton, mapped_skeleton);
+                auto mapped_clip = anim::view_clip(view, root->clip, skeleton);
+                bench::do_not_optimise(mapped_clip->key_frame_count());
+            });
+        report.add(map_result);
+        bench::print_speedup(block_result, map_result);
+
+        //sampling in place should give exactly what sampling the clip it was written from does
+        file::MappedFile mapped(blob_path);
+        file::BlobView view(mapped.bytes(), blob_header);
+        long long allocations_before_view = g_allocation_count;
+        auto mapped_clip = anim::view_clip(view, view.root<BenchBlob>()->clip, skeleton);
+        long long view_allocations = g_allocation_count - allocations_before_view;
+        float mapped_error = 0.f;
+        for (int i = 0; i < 100; ++i)
+        {
+            float time = random_float(0.f, long_uniform.duration());
+            anim::Pose expected = long_uniform.get_pose(time);
+            anim::Pose sampled = mapped_clip->get_pose(time);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                mapped_error = fmaxf(mapped_error, (expected.local_transforms[bone].translation - sampled.local_transforms[bone].translation).magnitude());
+            }
+        }
+        std::cout << "mapped clip blob: " << mapped.bytes().size() << " bytes, " << mapped_clip->memory_usage() << " bytes allocated for keyframes, "
+            << view_allocations << " heap allocations to view, max difference from the source clip: " << mapped_error << "\n";
+        mapped = file::MappedFile();
+        std::filesystem::remove(blob_path);
+    }
+
+    //compressed clips, identity and constant tracks are folded and animated tracks keep only the keys interpolation can't recreate
+    for (int key_frame_count : { g_key_frame_count, g_long_key_frame_count })
+    {
+        anim::Animation dense = create_smooth_clip(skeleton, key_frame_count);
+        auto compress_start = std::chrono::steady_clock::now();
+        anim::CompressedAnimation compressed(dense);
+        auto compress_duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compress_start);
+
+        auto statistics = compressed.statistics();
+        std::cout << key_frame_count << " keyframe clip compressed in " << compress_duration.count() << " ms: "
+            << dense.memory_usage() << " -> " << compressed.memory_usage() << " bytes ("
+            << (double)dense.memory_usage() / compressed.memory_usage() << "x), max error " << compressed.max_error() << "\n";
+        std::cout << "  tracks: " << statistics.identity_tracks << " identity, " << statistics.constant_tracks << " constant, "
+            << statistics.animated_tracks << " animated keeping " << statistics.animated_keys << " of " << statistics.source_keys << " keys\n";
+
+        for (float& time : times)
+        {
+            time = random_float(0.f, dense.duration());
+        }
+        std::string suffix = key_frame_count == g_key_frame_count ? "short" : "long";
+        auto dense_result = bench::run("get_pose_dense_" + suffix, 10, [&]()
+            {
+                for (float time : times)
+                {
+                    dense.get_pose(time, pose.local_transforms, true);
+                    bench::do_not_optimise(pose.local_transforms.back());
+                }
+            });
+        auto compressed_result = bench::run("get_pose_compressed_" + suffix, 10, [&]()
+            {
+                for (float time : times)
+                {
+                    compressed.get_pose(time, pose.local_transforms, true);
+                    bench::do_not_optimise(pose.local_transforms.back());
+                }
+            });
+        report.add(dense_result);
+        report.add(compressed_result);
+        bench::print_speedup(dense_result, compressed_result);
+
+        //the same clip as catmull-rom curves fitted to the keyframes
+        auto fit_start = std::chrono::steady_clock::now();
+        anim::CurveAnimation curves(dense);
+        auto fit_duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fit_start);
+        std::cout << key_frame_count << " keyframe clip fitted in " << fit_duration.count() << " ms: "
+            << dense.memory_usage() << " -> " << curves.memory_usage() << " bytes ("
+            << (double)dense.memory_usage() / curves.memory_usage() << "x), " << curves.knot_count() << " of " << 2 * key_frame_count * g_bone_count
+            << " knots, max error " << curves.max_translation_error() << " translation " << curves.max_rotation_error() << " rotation\n";
+        auto curves_result = bench::run("get_pose_curves_" + suffix, 10, [&]()
+            {
+                for (float time : times)
+                {
+                    curves.get_pose(time, pose.local_transforms, true);
+                    bench::do_not_optimise(pose.local_transforms.back());
+                }
+            });
+        report.add(curves_result);
+        bench::print_speedup(dense_result, curves_result);
+    }
+
+    //blending, a locomotion style cross-fade between two clips plus a masked additive layer, against sampling one clip
+    {
+        anim::Animation walk = create_smooth_clip(skeleton, g_key_frame_count);
+        anim::Animation run = create_smooth_clip(skeleton, g_key_frame_count);
+        anim::Animation lean = create_smooth_clip(skeleton, g_key_frame_count);
+        std::vector<anim::Transform> rest_pose(g_bone_count, { geom::Vector3::zero(), geom::Quaternion::identity() });
+        std::vector<float> upper_body(g_bone_count);
+        for (int bone = 0; bone < g_bone_count; ++bone)
+        {
+            upper_body[bone] = bone < g_bone_count / 2 ? 0.f : 1.f;
+        }
+        for (float& time : times)
+        {
+            time = random_float(0.f, walk.duration());
+        }
+        //the remaining fields keep their defaults
+        auto layer = [](const anim::Animation& animation, float time, float weight = 1.f, anim::BlendMode mode = anim::BlendMode::Override)
+        {
+            anim::BlendLayer result;
+            result.animation = &animation;
+            result.time = time;
+            result.weight = weight;
+            result.mode = mode;
+            return result;
+        };
+
+        //a single full weight layer is the clip, a pair of layers is an interpolation between them
+        //and an additive layer referenced to its own pose at the sampled time adds nothing
+        float single_error = 0.f;
+        float pair_error = 0.f;
+        float additive_error = 0.f;
+        std::vector<anim::Transform> blended(g_bone_count);
+        std::vector<anim::Transform> expected(g_bone_count);
+        anim::Pose walk_pose;
+        anim::Pose run_pose;
+        walk_pose.skeleton = run_pose.skeleton = &skeleton;
+        walk_pose.local_transforms.resize(g_bone_count);
+        run_pose.local_transforms.resize(g_bone_count);
+        auto max_difference = [](std::span<const anim::Transform> lhs, std::span<const anim::Transform> rhs)
+        {
+            float difference = 0.f;
+            for (size_t bone = 0; bone < lhs.size(); ++bone)
+            {
+                difference = fmaxf(difference, (lhs[bone].translation - rhs[bone].translation).magnitude());
+                float dot = fabsf(geom::Quaternion::dot(lhs[bone].rotation, rhs[bone].rotation));
+                difference = fmaxf(difference, 1.f - fminf(dot, 1.f));
+            }
+            return difference;
+        };
+        for (int i = 0; i < 100; ++i)
+        {
+            float time = times[i];
+            float weight = random_float(0.f, 1.f);
+            walk.get_pose(time, walk_pose.local_transforms, true);
+            run.get_pose(time, run_pose.local_transforms, true);
+
+            anim::BlendLayer single[] = { layer(walk, time) };
+            anim::blend_layers(single, rest_pose, blended);
+            single_error = fmaxf(single_error, max_difference(blended, walk_pose.local_transforms));
+
+            anim::BlendLayer pair[] = { layer(walk, time, 1.f - weight), layer(run, time, weight) };
+            anim::blend_layers(pair, rest_pose, blended);
+            anim::Pose::interpolate(walk_pose, run_pose, weight, expected, geom::RotationInterpolation::Nlerp);
+            pair_error = fmaxf(pair_error, max_difference(blended, expected));
+
+            anim::BlendLayer additive[] = { layer(walk, time), layer(walk, time, weight, anim::BlendMode::Additive) };
+            additive[1].reference_pose = walk_pose.local_transforms;
+            anim::blend_layers(additive, rest_pose, blended);
+            additive_error = fmaxf(additive_error, max_difference(blended, walk_pose.local_transforms));
+        }
+        std::cout << "blend max error, single layer: " << single_error << ", pair vs interpolate: " << pair_error << ", self referenced additive: " << additive_error << "\n";
+
+        auto single_result = bench::run("blend_single_clip", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    walk.get_pose(time, blended, true);
+                    bench::do_not_optimise(blended.back());
+                }
+            });
+        auto blend_result = bench::run("blend_cross_fade_additive", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    anim::BlendLayer layers[] = {
+                        layer(walk, time, 0.3f),
+                        layer(run, time, 0.7f),
+                        layer(lean, time, 0.5f, anim::BlendMode::Additive)
+                    };
+                    layers[2].bone_mask = upper_body;
+                    anim::blend_layers(layers, rest_pose, blended);
+                    bench::do_not_optimise(blended.back());
+                }
+            });
+        //the same blend by sampling each clip to a pose and combining them, as Pose::interpolate would be used
+        anim::Pose lean_pose;
+        lean_pose.skeleton = &skeleton;
+        lean_pose.local_transforms.resize(g_bone_count);
+        auto separate_result = bench::run("blend_separate_passes", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    walk.get_pose(time, walk_pose.local_transforms, true);
+                    run.get_pose(time, run_pose.local_transforms, true);
+                    lean.get_pose(time, lean_pose.local_transforms, true);
+                    anim::Pose::interpolate(walk_pose, run_pose, 0.7f, blended);
+                    for (int bone = g_bone_count / 2; bone < g_bone_count; ++bone)
+                    {
+                        anim::Transform reference = { lean.key_frame_translations(0)[bone], lean.key_frame_rotations(0)[bone] };
+                        auto difference = geom::Quaternion::slerp(geom::Quaternion::identity(), lean_pose.local_transforms[bone].rotation * reference.rotation.inverse(), 0.5f);
+                        blended[bone].translation += (lean_pose.local_transforms[bone].translation - reference.translation) * 0.5f;
+                        blended[bone].rotation = difference * blended[bone].rotation;
+                    }
+                    bench::do_not_optimise(blended.back());
+                }
+            });
+        report.add(single_result);
+        report.add(blend_result);
+        report.add(separate_result);
+        bench::print_speedup(single_result, blend_result);
+        bench::print_speedup(separate_result, blend_result);
+    }
+
+    //retargeting, one clip played on a rig with other proportions, bone orientations and bone order, matched by name
+    {
+        anim::Skeleton source = skeleton;
+        for (int bone = 0; bone < g_bone_count; ++bone)
+        {
+            source.bones[bone].name = "bone" + std::to_string(bone);
+        }
+        anim::Skeleton target = source;
+        for (auto& bone : target.bones)
+        {
+            bone.name = "rig:Bone" + bone.name.substr(4);
+            bone.global_transform.translation = bone.global_transform.translation * 1.5f;
+            bone.global_transform.rotation = bone.global_transform.rotation * random_transform().rotation;
+        }
+        std::vector<int> target_bones = anim::reorder_bones(target, anim::BoneOrder::DepthFirst);
+        anim::Animation clip = create_smooth_clip(source, g_key_frame_count);
+        anim::RetargetMap same_map(source, source, anim::BoneMatching::Hierarchy);
+        anim::RetargetMap map(source, target);
+        for (float& time : times)
+        {
+            time = random_float(0.f, clip.duration());
+        }
+
+        //onto its own skeleton the clip is unchanged, onto the other rig every joint is 1.5 times as far from the origin
+        //and every bone turns from its bind pose as the source bone does
+        float same_error = 0.f;
+        float position_error = 0.f;
+        float rotation_error = 0.f;
+        anim::Pose source_pose;
+        anim::Pose target_pose;
+        source_pose.skeleton = &source;
+        target_pose.skeleton = &target;
+        source_pose.local_transforms.resize(g_bone_count);
+        target_pose.local_transforms.resize(g_bone_count);
+        std::vector<anim::Transform> retargeted(g_bone_count);
+        for (float time : times)
+        {
+            clip.get_pose(time, source_pose.local_transforms, true);
+            same_map.get_pose(clip, time, retargeted, true);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                same_error = fmaxf(same_error, (retargeted[bone].translation - source_pose.local_transforms[bone].translation).magnitude());
+                same_error = fmaxf(same_error, 1.f - fabsf(geom::Quaternion::dot(retargeted[bone].rotation, source_pose.local_transforms[bone].rotation)));
+            }
+
+            map.get_pose(clip, time, target_pose.local_transforms, true);
+            auto source_globals = source_pose.get_global_transforms();
+            auto target_globals = target_pose.get_global_transforms();
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                const anim::Transform& expected = source_globals[bone];
+                const anim::Transform& actual = target_globals[target_bones[bone]];
+                auto expected_rotation = expected.rotation * source.bones[bone].global_transform.rotation.inverse() * target.bones[target_bones[bone]].global_transform.rotation;
+                position_error = fmaxf(position_error, (actual.translation - expected.translation * 1.5f).magnitude());
+                rotation_error = fmaxf(rotation_error, 1.f - fabsf(geom::Quaternion::dot(actual.rotation, expected_rotation)));
+            }
+        }
+        std::cout << "retarget max error onto own skeleton " << same_error << ", onto scaled rig position " << position_error << " rotation " << rotation_error
+            << ", " << map.mapped_bone_count() << " of " << g_bone_count << " bones matched by name, scale " << map.translation_scale() << "\n";
+        std::cout << "retarget table " << map.memory_usage() << " bytes per rig against " << clip.memory_usage() << " bytes per copied clip\n";
+
+        auto clip_result = bench::run("retarget_clip_sample", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    clip.get_pose(time, source_pose.local_transforms, true);
+                    bench::do_not_optimise(source_pose.local_transforms.back());
+                }
+            });
+        auto retarget_result = bench::run("retarget_sample", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    map.get_pose(clip, time, target_pose.local_transforms, true);
+                    bench::do_not_optimise(target_pose.local_transforms.back());
+                }
+            });
+        //sampling the source pose then converting it, an extra pass over an intermediate buffer
+        auto separate_result = bench::run("retarget_separate_passes", 10, [&]()
+            {
+                for (float time : times)
+                {
+                    clip.get_pose(time, source_pose.local_transforms, true);
+                    map.apply(source_pose.local_transforms, target_pose.local_transforms);
+                    bench::do_not_optimise(target_pose.local_transforms.back());
+                }
+            });
+        report.add(clip_result);
+        report.add(retarget_result);
+        report.add(separate_result);
+        bench::print_speedup(clip_result, retarget_result);
+        bench::print_speedup(separate_result, retarget_result);
+    }
+
+    //batch evaluation of a large crowd, each instance with its own cursor and buffers, at increasing thread counts
+    {
+        anim::Animation clip = create_smooth_clip(skeleton, g_key_frame_count);
+        std::vector<anim::PlaybackCursor> cursors(g_batch_instance_count);
+        std::vector<anim::Transform> local_transforms(g_batch_instance_count * g_bone_count);
+        std::vector<anim::Transform> batch_global_transforms(g_batch_instance_count * g_bone_count);
+        std::vector<geom::Matrix44> matrix_stacks(g_batch_instance_count * g_bone_count);
+        std::vector<anim::PoseJob> batch(g_batch_instance_count);
+        for (int i = 0; i < g_batch_instance_count; ++i)
+        {
+            auto& job = batch[i];
+            job.animation = &clip;
+            job.time = random_float(0.f, clip.duration());
+            job.cursor = &cursors[i];
+            job.local_transforms = { local_transforms.data() + i * g_bone_count, g_bone_count };
+            job.global_transforms = { batch_global_transforms.data() + i * g_bone_count, g_bone_count };
+            job.matrix_stack = { matrix_stacks.data() + i * g_bone_count, g_bone_count };
+        }
+
+        int hardware_threads = std::max((int)std::thread::hardware_concurrency(), 1);
+        std::cout << "hardware threads: " << hardware_threads << "\n";
+        std::vector<int> thread_counts = { 1 };
+        for (int thread_count = 2; thread_count < hardware_threads; thread_count *= 2)
+        {
+            thread_counts.push_back(thread_count);
+        }
+        if (hardware_threads > 1)
+        {
+            thread_counts.push_back(hardware_threads);
+        }
+
+        std::vector<bench::Result> batch_results;
+        for (int thread_count : thread_counts)
+        {
+            jobs::JobSystem job_system(thread_count);
+            batch_results.push_back(bench::run("batch_crowd_update_" + std::to_string(thread_count) + "_threads", 10, [&]()
+                {
+                    for (auto& job : batch)
+                    {
+                        job.time += 1.f / 60.f;
+                    }
+                    anim::evaluate_poses(batch, job_system);
+                }));
+            report.add(batch_results.back());
+        }
+        for (int i = 1; i < (int)batch_results.size(); ++i)
+        {
+            bench::print_speedup(batch_results[0], batch_results[i]);
+        }
+
+        //the batch should match evaluating each instance serially, and shouldn't allocate
+        jobs::JobSystem job_system(hardware_threads);
+        allocations_before = g_allocation_count;
+        anim::evaluate_poses(batch, job_system);
+        long long batch_allocations = g_allocation_count - allocations_before;
+        float batch_error = 0.f;
+        for (int i = 0; i < g_batch_instance_count; i += 97)
+        {
+            clip.get_pose(batch[i].time, pose.local_transforms, true);
+            pose.get_matrix_stack(matrix_stack, global_transforms);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                for (int j = 0; j < 16; ++j)
+                {
+                    batch_error = fmaxf(batch_error, fabsf(matrix_stack[bone].values[j] - batch[i].matrix_stack[bone].values[j]));
+                }
+            }
+        }
+        std::cout << "batch max difference from serial evaluation: " << batch_error << ", heap allocations: " << batch_allocations << "\n";
+
+        //the same crowd with lods, spread evenly over a disc 150 units across around the camera so most instances are distant
+        //a few frames are run per iteration so instances updating every few frames are counted fairly
+        constexpr int frames = 4;
+        anim::BoneLods bone_lods(skeleton);
+        anim::LodSettings lod_settings;
+        std::cout << "animated bones per bone lod:";
+        for (int level = 0; level < bone_lods.level_count(); ++level)
+        {
+            std::cout << " " << bone_lods.animated_bone_count(level);
+        }
+        std::cout << "\n";
+
+        std::vector<float> distances(g_batch_instance_count);
+        std::vector<anim::LodState> lod_states(g_batch_instance_count);
+        for (int i = 0; i < g_batch_instance_count; ++i)
+        {
+            distances[i] = 150.f * sqrtf(random_float(0.f, 1.f));
+            lod_states[i].frames_until_update = i;
+        }
+
+        jobs::JobSystem single_thread(1);
+        auto full_result = bench::run("lod_crowd_full_detail", 10, [&]()
+            {
+                for (int frame = 0; frame < frames; ++frame)
+                {
+                    for (auto& job : batch)
+                    {
+                        job.time += 1.f / 60.f;
+                    }
+                    anim::evaluate_poses(batch, single_thread);
+                }
+            });
+
+        std::vector<anim::PoseJob> lod_batch;
+        lod_batch.reserve(g_batch_instance_count);
+        int updated_instances = 0;
+        auto lod_result = bench::run("lod_crowd", 10, [&]()
+            {
+                updated_instances = 0;
+                for (int frame = 0; frame < frames; ++frame)
+                {
+                    lod_batch.clear();
+                    for (int i = 0; i < g_batch_instance_count; ++i)
+                    {
+                        batch[i].time += 1.f / 60.f;
+                        if (anim::update_lod(lod_settings, distances[i], lod_states[i]))
+                        {
+                            const anim::LodLevel& level = lod_settings.levels[lod_states[i].level];
+                            anim::PoseJob job = batch[i];
+                            job.bone_lods = &bone_lods;
+                            job.bone_lod = level.bone_lod;
+                            job.nearest_key = level.nearest_key;
+                            lod_batch.push_back(job);
+                        }
+                    }
+                    updated_instances += (int)lod_batch.size();
+                    anim::evaluate_poses(lod_batch, single_thread);
+                }
+            });
+        report.add(full_result);
+        report.add(lod_result);
+        bench::print_speedup(full_result, lod_result);
+        std::cout << "lod crowd evaluated " << (float)updated_instances / frames << " of " << g_batch_instance_count << " instances per frame\n";
+
+        //a crowd where instances share clips and start times, as when groups are spawned together
+        //the cache samples each distinct clip and time once rather than once per instance
+        constexpr int clip_count = 8;
+        constexpr int start_offset_count = 16;
+        std::vector<anim::Animation> crowd_clips;
+        for (int i = 0; i < clip_count; ++i)
+        {
+            crowd_clips.push_back(create_smooth_clip(skeleton, g_key_frame_count));
+        }
+        std::vector<float> start_offsets(g_batch_instance_count);
+        for (int i = 0; i < g_batch_instance_count; ++i)
+        {
+            batch[i].animation = &crowd_clips[i % clip_count];
+            batch[i].cursor = nullptr;
+            start_offsets[i] = (i / clip_count % start_offset_count) * 0.1f;
+        }
+
+        float crowd_time = 0.f;
+        auto duplicates_result = bench::run("shared_clips_crowd", 10, [&]()
+            {
+                crowd_time += 1.f / 60.f;
+                for (int i = 0; i < g_batch_instance_count; ++i)
+                {
+                    batch[i].time = crowd_time + start_offsets[i];
+                }
+                anim::evaluate_poses(batch, single_thread);
+            });
+
+        anim::SamplingCache cache;
+        std::vector<int> cache_entries(g_batch_instance_count);
+        auto cached_result = bench::run("shared_clips_crowd_cached", 10, [&]()
+            {
+                crowd_time += 1.f / 60.f;
+                cache.begin_frame();
+                for (int i = 0; i < g_batch_instance_count; ++i)
+                {
+                    cache_entries[i] = cache.request(*batch[i].animation, crowd_time + start_offsets[i]);
+                }
+                cache.evaluate(single_thread);
+                bench::do_not_optimise(cache.skinning_palette(cache_entries.back()).back());
+            });
+        report.add(duplicates_result);
+        report.add(cached_result);
+        bench::print_speedup(duplicates_result, cached_result);
+
+        //each instance's shared palette should match sampling it alone at the rounded time, and a warm cache shouldn't allocate
+        allocations_before = g_allocation_count;
+        cache.begin_frame();
+        for (int i = 0; i < g_batch_instance_count; ++i)
+        {
+            cache_entries[i] = cache.request(*batch[i].animation, crowd_time + start_offsets[i]);
+        }
+        cache.evaluate(single_thread);
+        long long cache_allocations = g_allocation_count - allocations_before;
+        float cache_error = 0.f;
+        for (int i = 0; i < g_batch_instance_count; i += 97)
+        {
+            float time = roundf((crowd_time + start_offsets[i]) / (1.f / 240.f)) * (1.f / 240.f);
+            batch[i].animation->get_pose(fmodf(time, batch[i].animation->duration()), pose.local_transforms);
+            pose.get_global_transforms(global_transforms);
+            anim::calculate_skinning_matrices(skeleton, global_transforms, matrix_stack);
+            auto cached = cache.skinning_palette(cache_entries[i]);
+            for (int bone = 0; bone < g_bone_count; ++bone)
+            {
+                for (int j = 0; j < 16; ++j)
+                {
+                    cache_error = fmaxf(cache_error, fabsf(matrix_stack[bone].values[j] - cached[bone].values[j]));
+                }
+            }
+        }
+        std::cout << "sampling cache: " << cache.entry_count() << " distinct poses for " << g_batch_instance_count
+            << " instances, max difference from sampling alone: " << cache_error << ", heap allocations: " << cache_allocations << "\n";
+    }
+
+    int result = report.finish(options);
+    if (frame_allocations != 0)
+    {
+        std::cout << "FAILED: the steady state frame should not allocate\n";
+        return 1;
+    }
+    return result;
+}
\ No newline at end of file
@@ -1,28 +1,126 @@
 #pragma once
 
+#include "key_times.h"
 #include "pose.h"
 #include "skeleton.h"
 
+#include <cstddef>
+#include <iosfwd>
+#include <span>
+
+namespace anim
+{
+    class Animation;
+}
+
+//native files, the skeleton isn't stored so an animation is read into one constructed with its skeleton
+//the channels are written and read as single blocks in the layout they're sampled from
+std::ofstream& operator<<(std::ofstream&, const anim::Animation&);
+std::ifstream& operator>>(std::ifstream&, anim::Animation&);
+
 namespace anim
 {
+    //remembers the keyframe used by the last sample, so playback that moves forward in small steps finds its keyframes in constant time
+    //one cursor per playing instance, a cursor can be reused with another animation as it is validated on every sample
+    struct PlaybackCursor
+    {
+        int key_frame = 0;
+    };
+
+    //the keyframes either side of a time and how far between them it is, both are the first or final keyframe outside the keyframes
+    struct SamplePoint
+    {
+        int key_frame = 0;
+        int next_key_frame = 0;
+        float t = 0.f;
+
+        //the keyframe nearer the time, sampled without interpolating
+        SamplePoint nearest() const;
+    };
+
+    //cheaper sampling for instances whose detail won't be seen
+    struct SampleLod
+    {
+        //bones to sample, the rest are left as they are in the output, empty samples every bone
+        std::span<const BoneRange> bones;
+        //take the nearest keyframe rather than interpolating between the keyframes either side
+        bool nearest_key = false;
+    };
+
     //a collection of timestamped poses (keyframes) that can be sampled for a pose using a time parameter
+    //keyframes are stored by channel rather than as poses, every translation then every rotation, each indexed by keyframe then bone
     class Animation
     {
     public:
         Animation(const Skeleton& skeleton) : m_skeleton(skeleton) {}
-        void add_keyframe(Pose, float time);
+        //an animation sampling keyframes stored elsewhere, such as in a mapped file, without copying them
+        //the channels are laid out as key_frame_translations and key_frame_rotations return them, a keyframe's bones at a time
+        //the memory must outlive the animation, and keyframes can't be added to it
+        static Animation borrow(
+            const Skeleton& skeleton,
+            KeyTimes key_times,
+            std::span<const Translation> translations,
+            std::span<const Rotation> rotations,
+            geom::RotationInterpolation rotation_interpolation = geom::RotationInterpolation::Slerp);
+
+        void add_keyframe(const Pose&, float time);
+        //avoids regrowing the channel storage when the number of keyframes is known up front
+        void reserve(int key_frame_count, int bone_count);
 
-        float duration() const { return m_duration; }
+        float duration() const { return m_key_times.duration(); }
+        const Skeleton& skeleton() const { return m_skeleton; }
         Pose get_pose(float time, bool loop = false) const;
+        Pose get_pose(float time, PlaybackCursor& cursor, bool loop = false) const;
+        //allocation free versions that write the local transforms to a caller owned buffer with a transform per bone
+        void get_pose(float time, std::span<Transform> out, bool loop = false) const;
+        void get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop = false) const;
+        void get_pose(float time, PlaybackCursor& cursor, const SampleLod& lod, std::span<Transform> out, bool loop = false) const;
+        //where time falls between the keyframes, so the channels of several clips can be sampled and combined in one pass
+        SamplePoint find_sample_point(float time, bool loop = false) const;
+        SamplePoint find_sample_point(float time, PlaybackCursor& cursor, bool loop = false) const;
+
+        //how rotations are interpolated between keyframes, slerp by default
+        //clips with small rotations between keyframes lose little accuracy with the cheaper methods
+        geom::RotationInterpolation rotation_interpolation() const { return m_rotation_interpolation; }
+        void set_rotation_interpolation(geom::RotationInterpolation method) { m_rotation_interpolation = method; }
+
+        //interval between keyframes if they lie on a fixed grid, in which case they are found by direct indexing, otherwise 0
+        float key_interval() const { return m_key_times.interval(); }
+        const KeyTimes& key_times() const { return m_key_times; }
+
+        int key_frame_count() const { return m_key_times.count(); }
+        int bone_count() const { return m_bone_count; }
+        std::span<const Translation> key_frame_translations(int key_frame) const;
+        std::span<const Rotation> key_frame_rotations(int key_frame) const;
+        //bytes allocated for keyframe data, borrowed keyframes aren't counted
+        size_t memory_usage() const;
+
+        friend std::ofstream& ::operator<<(std::ofstream&, const Animation&);
+        friend std::ifstream& ::operator>>(std::ifstream&, Animation&);
 
     private:
-        struct KeyFrame
-        {
-            Pose pose;
-            float time;
-        };
+        //local transforms at time between the keyframe and the next one, clamped to the first and final keyframes
+        SamplePoint sample_point(float time, int key_frame) const;
+        void sample(float time, int key_frame, std::span<Transform> out) const;
+        void sample(const SamplePoint&, const BoneRange&, std::span<Transform> out) const;
+        Pose sample(float time, int key_frame) const;
+        float wrap_time(float time, bool loop) const;
+
+        static size_t rotations_offset(int key_frame_capacity, int bone_count);
+        Translation* translations();
+        Rotation* rotations();
+        const Translation* translations() const;
+        const Rotation* rotations() const;
+
         const Skeleton& m_skeleton;
-        std::vector<KeyFrame> m_key_frames;
-        float m_duration = -1.f;
+        //both channels share one allocation, the rotations start after room for m_key_frame_capacity keyframes of translations
+        std::vector<std::byte> m_channels;
+        int m_key_frame_capacity = 0;
+        int m_bone_count = 0;
+        //set when the channels are borrowed rather than in m_channels
+        const Translation* m_borrowed_translations = nullptr;
+        const Rotation* m_borrowed_rotations = nullptr;
+        KeyTimes m_key_times;
+        geom::RotationInterpolation m_rotation_interpolation = geom::RotationInterpolation::Slerp;
     };
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "animation.h"
+#include "blend.h"
+#include "lod.h"
+#include "retarget.h"
+#include "transform.h"
+
+#include <span>
+
+namespace jobs
+{
+    class JobSystem;
+}
+
+namespace anim
+{
+    //one instance's sample of a clip, and the caller owned buffers the results are written to with a transform or matrix per bone
+    struct PoseJob
+    {
+        const Animation* animation = nullptr;
+        float time = 0.f;
+        bool loop = true;
+        //optional, the instance's cursor so forward playback finds its keyframes in constant time
+        PlaybackCursor* cursor = nullptr;
+        std::span<Transform> local_transforms;
+        std::span<Transform> global_transforms;
+        //optional, only the transforms are written if empty
+        std::span<geom::Matrix44> matrix_stack;
+        //optional, the combined palette for skinning, see calculate_skinning_matrices
+        std::span<geom::Matrix44> skinning_palette;
+        //optional, the skeleton's bone lods and the level to animate, bones the level drops are set to the rest pose
+        const BoneLods* bone_lods = nullptr;
+        int bone_lod = 0;
+        bool nearest_key = false;
+        //optional, plays the animation on another skeleton through the map, whose source must be the animation's skeleton
+        //the buffers and bone lods are then the map's target's
+        const RetargetMap* retarget = nullptr;
+    };
+
+    //one instance's blend of several clips, see blend_layers, written to buffers as for a PoseJob
+    struct BlendJob
+    {
+        const Skeleton* skeleton = nullptr;
+        std::span<const BlendLayer> layers;
+        std::span<const Transform> rest_pose;
+        std::span<Transform> local_transforms;
+        std::span<Transform> global_transforms;
+        //optional, only the transforms are written if empty
+        std::span<geom::Matrix44> matrix_stack;
+        std::span<geom::Matrix44> skinning_palette;
+    };
+
+    //samples every job's pose and builds its matrix stack, spread over the job system's threads
+    //jobs are independent so each is evaluated whole on one thread, grain_size is how many a thread takes at once
+    //jobs may share animations but not cursors or buffers
+    void evaluate_poses(std::span<const PoseJob> batch, jobs::JobSystem& job_system, int grain_size = 8);
+    void evaluate_blends(std::span<const BlendJob> batch, jobs::JobSystem& job_system, int grain_size = 4);
+}
\ No newline at end of file
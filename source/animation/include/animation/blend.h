@@ -0,0 +1,54 @@
+#pragma once
+
+#include "animation.h"
+#include "transform.h"
+
+#include <span>
+
+namespace anim
+{
+    enum class BlendMode
+    {
+        //blended with the other override layers by weight
+        Override,
+        //the clip's difference from a reference pose is added on top of the blended override layers
+        Additive
+    };
+
+    //a clip sampled at a time, contributing to a blended pose by its weight
+    struct BlendLayer
+    {
+        const Animation* animation = nullptr;
+        float time = 0.f;
+        bool loop = true;
+        float weight = 1.f;
+        BlendMode mode = BlendMode::Override;
+        //optional, the instance's cursor for this clip so forward playback finds its keyframes in constant time
+        PlaybackCursor* cursor = nullptr;
+        //optional weight per bone multiplying the layer's weight, e.g. 1 for the upper body and 0 elsewhere
+        //an empty mask applies the layer to every bone
+        std::span<const float> bone_mask;
+        //additive layers only, the local transform per bone that the clip's difference is taken from
+        //empty takes the difference from the clip's first keyframe
+        std::span<const Transform> reference_pose;
+    };
+
+    //layers are limited so they can be prepared on the stack
+    constexpr int g_max_blend_layers = 32;
+
+    //combines the layers into local transforms, out and rest_pose must have a transform per bone of the layers' skeleton
+    //each bone is the weighted average of the override layers, where their weights total less than one the rest pose makes up the difference
+    //rotations are averaged by weight then normalised, additive layers are then applied in order scaled by their weight
+    //the clips' keyframes are read directly and every layer is applied to a register's worth of bones before moving on,
+    //so nothing is sampled into intermediate buffers and the cost is a clip's interpolation per layer
+    //additive layers interpolate a second time to scale their difference by weight, so each costs about two override layers
+    //the rest pose is skipped when the unmasked override layers' weights reach one
+    //an empty rest pose uses the identity transform
+    void blend_layers(std::span<const BlendLayer> layers, std::span<const Transform> rest_pose, std::span<Transform> out);
+
+    //weight of the clip being faded to, elapsed seconds into a fade of duration seconds, with the fade eased in and out
+    //the clip being faded from takes one minus this, so the two layers always total one
+    float cross_fade_weight(float elapsed, float duration);
+    //sets the weights of a pair of override layers for a cross-fade from one to the other
+    void set_cross_fade(BlendLayer& from, BlendLayer& to, float elapsed, float duration);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "animation.h"
+#include "skeleton.h"
+
+#include "file/blob.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace anim
+{
+    //skeletons and clips in a file::BlobWriter's blob, as sections that are used in place once it's loaded or mapped
+    struct SkeletonBlob
+    {
+        file::BlobArray<char> name;
+        file::BlobArray<int32_t> parents;
+        file::BlobArray<Transform> global_transforms;
+        //every bone's name in bone order, name_ends has the end of each in names
+        file::BlobArray<char> names;
+        file::BlobArray<uint32_t> name_ends;
+    };
+
+    struct ClipBlob
+    {
+        file::BlobArray<char> name;
+        file::BlobArray<float> key_times;
+        //a keyframe's bones at a time, as Animation stores them
+        file::BlobArray<Translation> translations;
+        file::BlobArray<Rotation> rotations;
+        float key_interval = 0.f;
+        uint32_t final_interval_trimmed = 0;
+        uint32_t rotation_interpolation = 0;
+    };
+
+    SkeletonBlob add_skeleton(file::BlobWriter&, const Skeleton&);
+    //the skeleton is copied out rather than used in place, it's small and used as a Skeleton everywhere
+    //false if the sections aren't valid
+    bool read_skeleton(const file::BlobView&, const SkeletonBlob&, Skeleton& out);
+
+    ClipBlob add_clip(file::BlobWriter&, const Animation&, std::string_view name);
+    //an animation that samples the keyframes in place in the blob, the blob's memory must outlive it
+    //nothing if the sections aren't valid or don't match the skeleton
+    std::optional<Animation> view_clip(const file::BlobView&, const ClipBlob&, const Skeleton&);
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "animation.h"
+#include "key_times.h"
+#include "pose.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace anim
+{
+    //limits on the difference between a compressed clip and the one it was compressed from
+    //error is measured in model space at points around each bone, so it includes the error inherited from the bone's parents
+    struct CompressionSettings
+    {
+        //largest allowed distance between a point on the original and compressed skeletons, in the clip's units
+        float error_threshold = 0.01f;
+        //distance of the measured points from their bone, roughly the size of the geometry skinned to a bone
+        float shell_distance = 3.f;
+    };
+
+    //an animation with each bone's translation and rotation stored as a separate track, in the smallest form that stays within the error threshold
+    //identity tracks store nothing and constant tracks a single value, the rest keep only the keyframes that linear interpolation can't reproduce
+    //animated rotations are quantised to 48 bits by dropping their largest component, animated translations to 16 bits per component of the track's range
+    //unless that range is too large for 16 bits to stay well within the error threshold, as with root motion in long clips
+    //sampling finds and decodes two keys per track, so it costs two to three times sampling the dense clip in exchange for the memory
+    class CompressedAnimation
+    {
+    public:
+        CompressedAnimation(const Animation&, const CompressionSettings& settings = {});
+
+        float duration() const { return m_key_times.duration(); }
+        const Skeleton& skeleton() const { return m_skeleton; }
+        Pose get_pose(float time, bool loop = false) const;
+        Pose get_pose(float time, PlaybackCursor& cursor, bool loop = false) const;
+        void get_pose(float time, std::span<Transform> out, bool loop = false) const;
+        void get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop = false) const;
+
+        //starts as the source animation's method, which is the one the error was measured with
+        geom::RotationInterpolation rotation_interpolation() const { return m_rotation_interpolation; }
+        void set_rotation_interpolation(geom::RotationInterpolation method) { m_rotation_interpolation = method; }
+
+        int bone_count() const { return (int)m_rotation_tracks.size(); }
+        //largest error measured at the source animation's keyframes
+        //far from the origin, as with long root motion, float rounding of the measured points can put this slightly over the threshold
+        float max_error() const { return m_max_error; }
+        //bytes allocated for keyframe data
+        size_t memory_usage() const;
+
+        struct Statistics
+        {
+            int identity_tracks = 0;
+            int constant_tracks = 0;
+            int animated_tracks = 0;
+            //keys kept by the animated tracks, out of the source keyframe count for each
+            int animated_keys = 0;
+            int source_keys = 0;
+        };
+        Statistics statistics() const;
+
+    private:
+        enum class TrackType : uint8_t
+        {
+            Identity,
+            Constant,
+            Animated,
+            //translations only, keys are stored as floats
+            AnimatedFullPrecision
+        };
+
+        //first_key indexes the key frames and keys of the track's type, first_segment the segment keys
+        //for constant tracks value indexes the constants, for animated translation tracks it indexes the ranges
+        struct Track
+        {
+            TrackType type = TrackType::Identity;
+            uint16_t key_count = 0;
+            uint32_t first_key = 0;
+            uint32_t first_segment = 0;
+            uint32_t value = 0;
+        };
+
+        //the three smallest components of a unit quaternion, the index of the largest is in the top bits of the first two
+        struct PackedRotation
+        {
+            uint16_t values[3];
+        };
+
+        struct PackedTranslation
+        {
+            uint16_t values[3];
+        };
+
+        struct TranslationRange
+        {
+            Translation min;
+            Translation extent;
+        };
+
+        //chooses the form of each track, parents first so their error is known when measuring their children
+        class Compressor;
+
+        static PackedRotation pack(const Rotation&);
+        static Rotation unpack(const PackedRotation&);
+        static PackedTranslation pack(const Translation&, const TranslationRange&);
+        static Translation unpack(const PackedTranslation&, const TranslationRange&);
+
+        float wrap_time(float time, bool loop) const;
+        void sample(float time, int key_frame, std::span<Transform> out) const;
+        Pose sample(float time, int key_frame) const;
+        //how far time is from a track key to the next, clamped to the keys
+        static float key_fraction(float time, float key_time, float next_key_time);
+        //the keys either side of time and how far between them it is, so the rotations of several bones can be interpolated together
+        void find_rotation_keys(const Track&, float time, int key_frame, Rotation& key, Rotation& next_key, float& t) const;
+        Translation sample_translation(const Track&, float time, int key_frame) const;
+
+        const Skeleton& m_skeleton;
+        KeyTimes m_key_times;
+        std::vector<Track> m_rotation_tracks;
+        std::vector<Track> m_translation_tracks;
+        std::vector<Rotation> m_constant_rotations;
+        std::vector<Translation> m_constant_translations;
+        std::vector<TranslationRange> m_translation_ranges;
+        //source keyframe index of each key kept by the animated tracks
+        std::vector<uint16_t> m_rotation_key_frames;
+        std::vector<uint16_t> m_translation_key_frames;
+        std::vector<uint16_t> m_full_precision_translation_key_frames;
+        //segment keys of every animated track, see add_segment_keys
+        std::vector<uint16_t> m_segment_keys;
+        std::vector<PackedRotation> m_rotation_keys;
+        std::vector<PackedTranslation> m_translation_keys;
+        std::vector<Translation> m_full_precision_translation_keys;
+        float m_max_error = 0.f;
+        geom::RotationInterpolation m_rotation_interpolation = geom::RotationInterpolation::Slerp;
+    };
+}
\ No newline at end of file
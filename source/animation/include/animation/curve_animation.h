@@ -0,0 +1,76 @@
+#pragma once
+
+#include "animation.h"
+#include "key_times.h"
+#include "pose.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace anim
+{
+    //how closely the curves must follow the baked keyframes, measured in each bone's local space
+    struct CurveFitSettings
+    {
+        //largest distance between a fitted and baked translation, in the clip's units
+        float translation_tolerance = 0.01f;
+        //largest angle between a fitted and baked rotation in radians, 1e-4 moves a point 100 units from the bone by 0.01
+        float rotation_tolerance = 1e-4f;
+    };
+
+    //an animation with each bone's translation and rotation stored as a catmull-rom spline through a subset of the baked keyframes
+    //knots are added where a curve is furthest from the baked keyframes until every keyframe is within tolerance,
+    //so smooth motion needs a few knots per second rather than every baked keyframe
+    //rotations are fitted per component and normalised when sampled
+    class CurveAnimation
+    {
+    public:
+        CurveAnimation(const Animation&, const CurveFitSettings& settings = {});
+
+        float duration() const { return m_key_times.duration(); }
+        const Skeleton& skeleton() const { return m_skeleton; }
+        Pose get_pose(float time, bool loop = false) const;
+        Pose get_pose(float time, PlaybackCursor& cursor, bool loop = false) const;
+        void get_pose(float time, std::span<Transform> out, bool loop = false) const;
+        void get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop = false) const;
+
+        int bone_count() const { return (int)m_rotation_curves.size(); }
+        //knots kept by every curve, out of a knot per baked keyframe for each
+        int knot_count() const { return (int)(m_translation_knots.size() + m_rotation_knots.size()); }
+        //largest errors measured at the baked keyframes
+        float max_translation_error() const { return m_max_translation_error; }
+        float max_rotation_error() const { return m_max_rotation_error; }
+        //bytes allocated for keyframe data
+        size_t memory_usage() const;
+
+    private:
+        //first_knot indexes the knot frames and knots of the curve's channel, first_segment the segment keys
+        struct Curve
+        {
+            uint16_t knot_count = 0;
+            uint32_t first_knot = 0;
+            uint32_t first_segment = 0;
+        };
+
+        float wrap_time(float time, bool loop) const;
+        void sample(float time, int key_frame, std::span<Transform> out) const;
+        Pose sample(float time, int key_frame) const;
+        template<typename Value>
+        Value evaluate(const Curve&, const uint16_t* knot_frames, const Value* knots, float time, int key_frame) const;
+
+        const Skeleton& m_skeleton;
+        KeyTimes m_key_times;
+        std::vector<Curve> m_translation_curves;
+        std::vector<Curve> m_rotation_curves;
+        //baked keyframe index of each knot
+        std::vector<uint16_t> m_translation_knot_frames;
+        std::vector<uint16_t> m_rotation_knot_frames;
+        std::vector<Translation> m_translation_knots;
+        std::vector<Rotation> m_rotation_knots;
+        //segment keys of every curve, see add_segment_keys
+        std::vector<uint16_t> m_segment_keys;
+        float m_max_translation_error = 0.f;
+        float m_max_rotation_error = 0.f;
+    };
+}
\ No newline at end of file
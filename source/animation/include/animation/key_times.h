@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace anim
+{
+    //the times of a clip's keyframes, in increasing order
+    //finds the keyframe at or before a time by direct indexing if the keyframes lie on a fixed grid, otherwise by binary search
+    class KeyTimes
+    {
+    public:
+        //times stored elsewhere, such as in a mapped file, with the interval found when they were added, the memory must outlive the key times
+        static KeyTimes borrow(std::span<const float> times, float interval, bool final_interval_trimmed);
+
+        void add(float time);
+        void reserve(int count) { m_times.reserve(count); }
+
+        int count() const { return (int)times().size(); }
+        bool empty() const { return times().empty(); }
+        float operator[](int key_frame) const { return times()[key_frame]; }
+        std::span<const float> times() const { return m_borrowed.empty() ? std::span<const float>(m_times) : m_borrowed; }
+        //time of the final keyframe, or -1 if there are none
+        float duration() const { return empty() ? -1.f : times().back(); }
+        //interval between keyframes if they lie on a fixed grid, otherwise 0
+        float interval() const { return m_interval; }
+        //whether the final keyframe is closer to the one before than the interval, as when the importer trims it to the clip's duration
+        bool final_interval_trimmed() const { return m_final_interval_trimmed; }
+
+        //index of the keyframe at or before time, or the first keyframe if time is before it
+        //the hinted version checks the hint and the keyframe after it before searching
+        int find(float time) const;
+        int find(float time, int hint) const;
+
+        size_t memory_usage() const { return m_times.capacity() * sizeof(float); }
+
+    private:
+        void update_interval(float time);
+        int search(float time) const;
+
+        std::vector<float> m_times;
+        std::span<const float> m_borrowed;
+        float m_interval = 0.f;
+        bool m_final_interval_trimmed = false;
+    };
+
+    //tracks that keep a subset of a clip's keyframes store the index of each keyframe they kept
+    //each track also stores the index of its key at or before the start of every segment of keyframes,
+    //so finding a key is a short scan from its segment's key whatever the length of the clip
+    constexpr int g_segment_key_frames = 16;
+    //appends the track's segment keys to segment_keys
+    void add_segment_keys(std::span<const uint16_t> key_frames, int clip_key_frame_count, std::vector<uint16_t>& segment_keys);
+    //index into key_frames of the key at or before the keyframe, segment_keys starts at the track's first segment key
+    int find_track_key(std::span<const uint16_t> key_frames, const uint16_t* segment_keys, int key_frame);
+}
+
+//inline definitions
+namespace anim
+{
+    inline int find_track_key(std::span<const uint16_t> key_frames, const uint16_t* segment_keys, int key_frame)
+    {
+        int key = segment_keys[key_frame / g_segment_key_frames];
+        while (key + 1 < (int)key_frames.size() && key_frames[key + 1] <= key_frame)
+        {
+            ++key;
+        }
+        return key;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "pose.h"
+#include "skeleton.h"
+#include "transform.h"
+
+#include <span>
+#include <vector>
+
+namespace anim
+{
+    //the bones of a skeleton to animate at each bone level of detail
+    //level 0 is every bone, each level after drops the bones that were leaves of the level before, so fingers and toes go first
+    //dropped bones are held in the skeleton's rest pose, so skinning still has a matrix for them that follows their parent
+    class BoneLods
+    {
+    public:
+        BoneLods(const Skeleton&, int level_count = 4);
+
+        int level_count() const { return (int)m_levels.size(); }
+        //runs of bones animated at the level, and the runs that are held at rest
+        std::span<const BoneRange> animated_bones(int level) const;
+        std::span<const BoneRange> rest_bones(int level) const;
+        int animated_bone_count(int level) const { return m_levels[level].animated_bone_count; }
+        //local transform of each bone in the skeleton's bind pose
+        std::span<const Transform> rest_pose() const { return m_rest_pose; }
+
+        //copies the rest pose into the bones the level doesn't animate
+        void apply_rest_pose(int level, std::span<Transform> local_transforms) const;
+
+    private:
+        struct Level
+        {
+            int first_animated = 0;
+            int animated_count = 0;
+            int first_rest = 0;
+            int rest_count = 0;
+            int animated_bone_count = 0;
+        };
+
+        std::vector<Level> m_levels;
+        std::vector<BoneRange> m_ranges;
+        std::vector<Transform> m_rest_pose;
+    };
+
+    //how an instance is animated from a distance from the camera onwards
+    struct LodLevel
+    {
+        float distance = 0.f;
+        //level of the skeleton's BoneLods to animate
+        int bone_lod = 0;
+        //frames between updates, the matrix palette from the last update is reused in between
+        int update_interval = 1;
+        //sample the nearest keyframe rather than interpolating
+        bool nearest_key = false;
+    };
+
+    //levels in increasing order of distance, the first should start at 0
+    struct LodSettings
+    {
+        std::vector<LodLevel> levels = {
+            { 0.f, 0, 1, false },
+            { 20.f, 1, 1, false },
+            { 50.f, 2, 2, false },
+            { 100.f, 3, 4, true },
+        };
+    };
+
+    //the lod of one instance, carried between frames
+    struct LodState
+    {
+        //index into the settings' levels, -1 before the first update
+        int level = -1;
+        //instances with the same interval update on the same frame unless this is seeded with different values to spread them out
+        int frames_until_update = 0;
+    };
+
+    //index of the level used at a distance
+    int select_lod(const LodSettings&, float distance);
+
+    //picks the instance's level for this frame, and returns whether it should be animated this frame
+    //an instance changing level is always animated, so it never shows a palette from the previous level
+    bool update_lod(const LodSettings&, float distance, LodState&);
+}
\ No newline at end of file
@@ -2,19 +2,50 @@
 
 #include "transform.h"
 
+#include <span>
 #include <vector>
 
 namespace anim
 {
     class Skeleton;
 
+    //a run of consecutive bones, from begin up to but not including end
+    struct BoneRange
+    {
+        int begin = 0;
+        int end = 0;
+    };
+
     //a collection of local transforms that represent a pose for a referenced skeleton 
     struct Pose
     {
         const Skeleton* skeleton;
         std::vector<Transform> local_transforms;
 
-        static Pose interpolate(const Pose&, const Pose&, float t);
+        static Pose interpolate(const Pose&, const Pose&, float t, geom::RotationInterpolation method = geom::RotationInterpolation::Slerp);
+
+        //model space transforms, composed down the hierarchy without going through matrices
+        std::vector<Transform> get_global_transforms() const;
         std::vector<geom::Matrix44> get_matrix_stack() const;
+        std::vector<geom::Matrix34> get_affine_matrix_stack() const;
+
+        //allocation free versions that write to caller owned buffers with a transform or matrix per bone
+        //the matrix stacks are built from the global transforms, which are written to global_transforms on the way
+        static void interpolate(const Pose&, const Pose&, float t, std::span<Transform> out, geom::RotationInterpolation method = geom::RotationInterpolation::Slerp);
+        void get_global_transforms(std::span<Transform> out) const;
+        void get_matrix_stack(std::span<geom::Matrix44> out, std::span<Transform> global_transforms) const;
+        void get_affine_matrix_stack(std::span<geom::Matrix34> out, std::span<Transform> global_transforms) const;
     };
+
+    //model space transforms of a skeleton's bones from their local transforms, out must be the same size as local_transforms
+    void calculate_global_transforms(const Skeleton&, std::span<const Transform> local_transforms, std::span<Transform> out);
+    //the matrix per bone that takes a vertex from the bind pose to the posed skeleton, each global transform times the bone's inverse bind transform
+    //a shader then needs only this one palette rather than the matrix stack and inverse bind matrices
+    void calculate_skinning_matrices(const Skeleton&, std::span<const Transform> global_transforms, std::span<geom::Matrix44> out);
+
+    //interpolates local transforms held as separate translation and rotation channels, as animations store their keyframes
+    void interpolate_channels(
+        std::span<const Translation> translations1, std::span<const Rotation> rotations1,
+        std::span<const Translation> translations2, std::span<const Rotation> rotations2,
+        float t, geom::RotationInterpolation method, std::span<Transform> out);
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "animation.h"
+#include "skeleton.h"
+#include "transform.h"
+
+#include <span>
+#include <vector>
+
+namespace anim
+{
+    //how the bones of two skeletons are paired up
+    enum class BoneMatching
+    {
+        //bones with the same name, ignoring case and any namespace prefix such as "mixamorig:"
+        Name,
+        //bones at the same place in the hierarchy, pairing the roots then each pair's children in order
+        Hierarchy
+    };
+
+    //a table for playing animations made for one skeleton on another, built once per pair of skeletons
+    //each target bone has the source bone it follows and rotations correcting for the difference between their bind poses,
+    //so a bone moves from its own bind pose the way the source bone moves from its one, and one clip can drive any number of rigs
+    //translations move by the source's offset from its bind pose scaled by the ratio of the skeletons' sizes,
+    //so limbs keep the target's proportions while root motion is scaled to the target's stride
+    //target bones without a source bone are held in the target's bind pose
+    class RetargetMap
+    {
+    public:
+        RetargetMap(const Skeleton& source, const Skeleton& target, BoneMatching matching = BoneMatching::Name);
+
+        const Skeleton& source() const { return *m_source; }
+        const Skeleton& target() const { return *m_target; }
+        //source bone the target bone follows, -1 if it is held in its bind pose
+        int source_bone(int target_bone) const { return m_source_bones[target_bone]; }
+        int mapped_bone_count() const { return (int)m_bones.size(); }
+        //target bone lengths over the source's, the scale of translations from the bind pose
+        float translation_scale() const { return m_translation_scale; }
+        //bytes allocated for the table, which is all a rig adds to a shared clip
+        size_t memory_usage() const
+        {
+            return m_bones.capacity() * sizeof(BoneMapping) + m_held_bones.capacity() * sizeof(HeldBone) + m_source_bones.capacity() * sizeof(int);
+        }
+
+        //local transforms of the target from local transforms of the source, out must have a transform per target bone
+        void apply(std::span<const Transform> source_local_transforms, std::span<Transform> out) const;
+        //samples an animation made for the source straight into the target's local transforms
+        //the table is walked in source bone order, so consecutive source bones are read from the keyframes as a block as sampling
+        //the clip would, and each result is written to its target bone, so nothing is sampled into an intermediate buffer
+        void get_pose(const Animation&, float time, std::span<Transform> out, bool loop = false) const;
+        void get_pose(const Animation&, float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop = false) const;
+        void sample(const Animation&, const SamplePoint&, std::span<Transform> out) const;
+
+    private:
+        //target local transform = { target_bind_translation + parent_correction * (source translation - source_bind_translation) * scale,
+        //                           parent_correction * source rotation * correction }
+        struct BoneMapping
+        {
+            Rotation parent_correction;
+            Rotation correction;
+            Translation source_bind_translation;
+            Translation target_bind_translation;
+            int source_bone = -1;
+            int target_bone = -1;
+        };
+        //a target bone without a source bone and the local transform of its bind pose
+        struct HeldBone
+        {
+            int target_bone;
+            Transform bind;
+        };
+
+        template<typename Gather>
+        void retarget(Gather&& gather, std::span<Transform> out) const;
+
+        const Skeleton* m_source;
+        const Skeleton* m_target;
+        //the mapped target bones, sorted by source bone
+        std::vector<BoneMapping> m_bones;
+        std::vector<HeldBone> m_held_bones;
+        //per target bone
+        std::vector<int> m_source_bones;
+        float m_translation_scale = 1.f;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "animation.h"
+#include "batch.h"
+#include "lod.h"
+#include "retarget.h"
+#include "transform.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace jobs
+{
+    class JobSystem;
+}
+
+namespace anim
+{
+    //shares sampled poses between instances playing the same clip at the same time, one frame at a time
+    //instances request an entry for their clip, time and lod, each distinct entry is evaluated once and read by all of them
+    //times are rounded to a multiple of the time quantum, so instances that are almost in step share a pose sampled at the rounded time
+    class SamplingCache
+    {
+    public:
+        //0 only shares exactly equal times
+        explicit SamplingCache(float time_quantum = 1.f / 240.f);
+
+        //forgets the previous frame's entries, their buffers are kept so a steady state frame doesn't allocate
+        void begin_frame();
+        //index of the entry for the clip sampled at time, added if it hasn't been requested this frame
+        //bone_lods is the clip's skeleton's, and may be null to animate every bone
+        //with a retarget map the clip is played on the map's target skeleton, and bone_lods is the target's
+        int request(const Animation&, float time, bool loop = true, const BoneLods* bone_lods = nullptr, int bone_lod = 0, bool nearest_key = false,
+            const RetargetMap* retarget = nullptr);
+        //samples every entry requested since begin_frame, spread over the job system's threads
+        void evaluate(jobs::JobSystem&);
+
+        int entry_count() const { return (int)m_entries.size(); }
+        //valid from evaluate until the next begin_frame
+        std::span<const Transform> local_transforms(int entry) const;
+        std::span<const Transform> global_transforms(int entry) const;
+        //the combined palette for skinning, see calculate_skinning_matrices
+        std::span<const geom::Matrix44> skinning_palette(int entry) const;
+
+    private:
+        struct Entry
+        {
+            const Animation* animation = nullptr;
+            //the rounded time, which is the time sampled
+            float time = 0.f;
+            const BoneLods* bone_lods = nullptr;
+            int bone_lod = 0;
+            bool nearest_key = false;
+            const RetargetMap* retarget = nullptr;
+            //index of the entry's first bone in the buffers
+            int first_bone = 0;
+        };
+
+        static uint64_t hash(const Animation*, const RetargetMap*, const BoneLods*, float time, int bone_lod, bool nearest_key);
+        //bones of the skeleton the entry is played on
+        static int bone_count(const Entry&);
+        //open addressing with linear probing, slots hold an entry index or -1 and the table is kept at most half full
+        void grow_slots();
+
+        float m_time_quantum;
+        std::vector<Entry> m_entries;
+        std::vector<int> m_slots;
+        std::vector<Transform> m_local_transforms;
+        std::vector<Transform> m_global_transforms;
+        std::vector<geom::Matrix44> m_skinning_palettes;
+        std::vector<PoseJob> m_jobs;
+    };
+}
\ No newline at end of file
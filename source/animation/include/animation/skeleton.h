@@ -3,6 +3,8 @@
 #include "pose.h"
 #include "transform.h"
 
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -15,13 +17,49 @@ namespace anim
         {
             int parent_index;
             Transform global_transform;
+            //used to match bones between skeletons, see RetargetMap
+            std::string name;
         };
 
         std::string name;
         std::vector<Bone> bones;
+
+        //bind pose data derived from the bones' global transforms, cached by update_hierarchy
+        std::vector<geom::Matrix44> bind_matrix_stack;
         std::vector<geom::Matrix44> inv_matrix_stack;
 
-        std::vector<geom::Matrix44> matrix_stack();
+        //compact copies of the hierarchy for walking it, rebuilt from bones by update_hierarchy
+        //parents holds each bone's parent index, so a walk streams through two bytes per bone rather than a whole Bone
+        std::vector<int16_t> parents;
+        //the bones at each depth from the roots, only filled when the bones are sorted by depth as by breadth first ordering
+        //every bone in a level depends only on earlier levels, so a level's global transforms can be computed together
+        std::vector<BoneRange> depth_levels;
+
+        //call after the bones change
+        void update_hierarchy();
+
+        //the bind pose's global matrix per bone
+        const std::vector<geom::Matrix44>& matrix_stack() const { return bind_matrix_stack; }
+        //copies the bind pose matrices, out must have a matrix per bone
+        void matrix_stack(std::span<geom::Matrix44> out) const;
         static bool equivalent(const Skeleton&, const Skeleton&);
     };
-}
\ No newline at end of file
+
+    enum class BoneOrder
+    {
+        //each bone is followed by its descendants, so a limb's bones are consecutive
+        DepthFirst,
+        //bones are sorted by depth, so the hierarchy can be walked a level at a time
+        BreadthFirst
+    };
+
+    //sorts the bones topologically so parents come first and each is near the bones it's used with, then updates the hierarchy
+    //returns the new index of each old bone, for remapping skin indices and anything else indexed by bone
+    //anything sampled per bone, like animations, must be built after reordering or have its bones remapped to match
+    std::vector<int> reorder_bones(Skeleton&, BoneOrder order = BoneOrder::BreadthFirst);
+}
+
+//native files, alongside the serializers in file/binary_serializer.h
+//only the bones are stored, the data derived from them is rebuilt on reading
+std::ofstream& operator<<(std::ofstream&, const anim::Skeleton&);
+std::ifstream& operator>>(std::ifstream&, anim::Skeleton&);
\ No newline at end of file
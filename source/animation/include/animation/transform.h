@@ -3,6 +3,8 @@
 #include "maths/vector3.h"
 #include "maths/quaternion.h"
 
+#include <span>
+
 namespace anim
 {
     using Translation = geom::Vector3;
@@ -15,7 +17,16 @@ namespace anim
         Rotation rotation;
 
         geom::Matrix44 calculate_matrix() const;
+        geom::Matrix34 calculate_matrix_34() const;
+        //for unit rotations, inverse() * transform is the identity
+        Transform inverse() const;
     };
 
     bool operator==(const Transform&, const Transform&);
+    //combines two transforms the same way as multiplying their matrices, rhs is applied first
+    Transform operator*(const Transform& lhs, const Transform& rhs);
+
+    //matrix for each transform, out must be the same size as transforms
+    void calculate_matrices(std::span<const Transform> transforms, std::span<geom::Matrix44> out);
+    void calculate_matrices(std::span<const Transform> transforms, std::span<geom::Matrix34> out);
 }
\ No newline at end of file
@@ -1,45 +1,302 @@
 #include "animation.h"
 
+#include "file/binary_serializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 namespace anim
 {
-    void Animation::add_keyframe(Pose pose, float time)
+    SamplePoint SamplePoint::nearest() const
+    {
+        int nearest_key_frame = t < 0.5f ? key_frame : next_key_frame;
+        return { nearest_key_frame, nearest_key_frame, 0.f };
+    }
+
+    Animation Animation::borrow(
+        const Skeleton& skeleton,
+        KeyTimes key_times,
+        std::span<const Translation> translations,
+        std::span<const Rotation> rotations,
+        geom::RotationInterpolation rotation_interpolation)
+    {
+        int bone_count = (int)skeleton.bones.size();
+        _ASSERT(translations.size() == (size_t)key_times.count() * bone_count);
+        _ASSERT(rotations.size() == translations.size());
+
+        Animation animation(skeleton);
+        animation.m_key_times = std::move(key_times);
+        animation.m_bone_count = bone_count;
+        animation.m_borrowed_translations = translations.data();
+        animation.m_borrowed_rotations = rotations.data();
+        animation.m_rotation_interpolation = rotation_interpolation;
+        return animation;
+    }
+
+    void Animation::add_keyframe(const Pose& pose, float time)
     {
         //assume that keyframes will be added in order for now
-        _ASSERT(time > m_duration);
+        _ASSERT(time > duration());
         _ASSERT(pose.skeleton == &m_skeleton);
-        m_duration = time;
-        m_key_frames.push_back({ std::move(pose), time });
+
+        int key_frame = key_frame_count();
+        int bone_count = (int)pose.local_transforms.size();
+        _ASSERT(key_frame == 0 || bone_count == m_bone_count);
+        if (key_frame == m_key_frame_capacity)
+        {
+            reserve(std::max(2 * m_key_frame_capacity, 16), bone_count);
+        }
+
+        Translation* key_translations = translations() + key_frame * m_bone_count;
+        Rotation* key_rotations = rotations() + key_frame * m_bone_count;
+        for (int bone = 0; bone < m_bone_count; ++bone)
+        {
+            key_translations[bone] = pose.local_transforms[bone].translation;
+            key_rotations[bone] = pose.local_transforms[bone].rotation;
+        }
+
+        m_key_times.add(time);
+    }
+
+    void Animation::reserve(int key_frame_count, int bone_count)
+    {
+        _ASSERT(m_borrowed_translations == nullptr);
+        _ASSERT(m_key_times.empty() || bone_count == m_bone_count);
+        if (key_frame_count <= m_key_frame_capacity)
+        {
+            return;
+        }
+
+        std::vector<std::byte> channels(rotations_offset(key_frame_count, bone_count) + key_frame_count * bone_count * sizeof(Rotation));
+
+        //the channels are trivially copyable, so moving them to the larger allocation is a copy of each channel's used range
+        size_t used = m_key_times.count() * bone_count;
+        if (used > 0)
+        {
+            memcpy(channels.data(), m_channels.data(), used * sizeof(Translation));
+            memcpy(
+                channels.data() + rotations_offset(key_frame_count, bone_count),
+                m_channels.data() + rotations_offset(m_key_frame_capacity, bone_count),
+                used * sizeof(Rotation));
+        }
+
+        m_channels = std::move(channels);
+        m_key_frame_capacity = key_frame_count;
+        m_bone_count = bone_count;
+        m_key_times.reserve(key_frame_count);
+    }
+
+    std::span<const Translation> Animation::key_frame_translations(int key_frame) const
+    {
+        return { translations() + key_frame * m_bone_count, (size_t)m_bone_count };
+    }
+
+    std::span<const Rotation> Animation::key_frame_rotations(int key_frame) const
+    {
+        return { rotations() + key_frame * m_bone_count, (size_t)m_bone_count };
+    }
+
+    size_t Animation::memory_usage() const
+    {
+        return m_channels.capacity() + m_key_times.memory_usage();
     }
 
     Pose Animation::get_pose(float time, bool loop) const
     {
-        //if loop is enabled then ensure time is within duration
-        time = loop ? fmodf(time, m_duration) : time;
+        time = wrap_time(time, loop);
+        return sample(time, m_key_times.find(time));
+    }
 
-        //if time is outside duration (only possible if not looping) then take first or final keyframe
-        if (time <= 0)
+    Pose Animation::get_pose(float time, PlaybackCursor& cursor, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        return sample(time, cursor.key_frame);
+    }
+
+    void Animation::get_pose(float time, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        sample(time, m_key_times.find(time), out);
+    }
+
+    void Animation::get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        sample(time, cursor.key_frame, out);
+    }
+
+    void Animation::get_pose(float time, PlaybackCursor& cursor, const SampleLod& lod, std::span<Transform> out, bool loop) const
+    {
+        _ASSERT(out.size() == m_bone_count);
+
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        SamplePoint point = sample_point(time, cursor.key_frame);
+        if (lod.nearest_key)
         {
-            return m_key_frames[0].pose;
+            point = point.nearest();
         }
-        if (time >= m_duration)
+
+        if (lod.bones.empty())
         {
-            return m_key_frames.back().pose;
+            sample(point, { 0, m_bone_count }, out);
+            return;
         }
+        for (const BoneRange& bones : lod.bones)
+        {
+            sample(point, bones, out);
+        }
+    }
 
-        //interpolate between two adjacent keyframes
-        int i = 1;
-        float t = 0.f;
-        for (; i < m_key_frames.size(); ++i)
+    SamplePoint Animation::find_sample_point(float time, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        return sample_point(time, m_key_times.find(time));
+    }
+
+    SamplePoint Animation::find_sample_point(float time, PlaybackCursor& cursor, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        return sample_point(time, cursor.key_frame);
+    }
+
+    SamplePoint Animation::sample_point(float time, int key_frame) const
+    {
+        //outside the keyframes (only possible if not looping) take the first or final keyframe
+        if (key_frame + 1 >= key_frame_count() || time <= m_key_times[key_frame])
         {
-            float key_frame_time = m_key_frames[i].time;
-            if (time < key_frame_time)
+            return { key_frame, key_frame, 0.f };
+        }
+
+        float prev_key_frame_time = m_key_times[key_frame];
+        float t = (time - prev_key_frame_time) / (m_key_times[key_frame + 1] - prev_key_frame_time);
+        return { key_frame, key_frame + 1, t };
+    }
+
+    void Animation::sample(float time, int key_frame, std::span<Transform> out) const
+    {
+        _ASSERT(out.size() == m_bone_count);
+
+        sample(sample_point(time, key_frame), { 0, m_bone_count }, out);
+    }
+
+    void Animation::sample(const SamplePoint& point, const BoneRange& bones, std::span<Transform> out) const
+    {
+        _ASSERT(bones.begin >= 0 && bones.begin <= bones.end && bones.end <= m_bone_count);
+
+        int count = bones.end - bones.begin;
+        auto key_translations = key_frame_translations(point.key_frame).subspan(bones.begin, count);
+        auto key_rotations = key_frame_rotations(point.key_frame).subspan(bones.begin, count);
+        auto range_out = out.subspan(bones.begin, count);
+        if (point.key_frame == point.next_key_frame)
+        {
+            for (int bone = 0; bone < count; ++bone)
             {
-                float prev_key_frame_time = m_key_frames[i - 1].time;
-                t = (time - prev_key_frame_time) / (key_frame_time - prev_key_frame_time);
-                break;
+                range_out[bone] = { key_translations[bone], key_rotations[bone] };
             }
+            return;
         }
 
-        return Pose::interpolate(m_key_frames[i - 1].pose, m_key_frames[i].pose, t);
+        //interpolate between two adjacent keyframes
+        interpolate_channels(
+            key_translations, key_rotations,
+            key_frame_translations(point.next_key_frame).subspan(bones.begin, count),
+            key_frame_rotations(point.next_key_frame).subspan(bones.begin, count),
+            point.t, m_rotation_interpolation, range_out);
+    }
+
+    Pose Animation::sample(float time, int key_frame) const
+    {
+        Pose pose;
+        pose.skeleton = &m_skeleton;
+        pose.local_transforms.resize(m_bone_count);
+        sample(time, key_frame, pose.local_transforms);
+        return pose;
+    }
+
+    size_t Animation::rotations_offset(int key_frame_capacity, int bone_count)
+    {
+        //rotations start at a 16 byte boundary so a quaternion never straddles a cache line
+        return (key_frame_capacity * bone_count * sizeof(Translation) + 15) & ~size_t(15);
+    }
+
+    Translation* Animation::translations()
+    {
+        return reinterpret_cast<Translation*>(m_channels.data());
+    }
+
+    Rotation* Animation::rotations()
+    {
+        return reinterpret_cast<Rotation*>(m_channels.data() + rotations_offset(m_key_frame_capacity, m_bone_count));
+    }
+
+    const Translation* Animation::translations() const
+    {
+        return m_borrowed_translations ? m_borrowed_translations : const_cast<Animation*>(this)->translations();
+    }
+
+    const Rotation* Animation::rotations() const
+    {
+        return m_borrowed_rotations ? m_borrowed_rotations : const_cast<Animation*>(this)->rotations();
+    }
+
+    float Animation::wrap_time(float time, bool loop) const
+    {
+        //if loop is enabled then ensure time is within duration
+        return loop ? fmodf(time, duration()) : time;
+    }
+}
+
+std::ofstream& operator<<(std::ofstream& stream, const anim::Animation& animation)
+{
+    int key_frame_count = animation.key_frame_count();
+    int value_count = key_frame_count * animation.m_bone_count;
+    stream << animation.m_bone_count << key_frame_count << animation.m_rotation_interpolation;
+    file::write_array(stream, animation.m_key_times.times());
+    file::write_array(stream, std::span<const anim::Translation>(animation.translations(), value_count));
+    file::write_array(stream, std::span<const anim::Rotation>(animation.rotations(), value_count));
+    return stream;
+}
+
+std::ifstream& operator>>(std::ifstream& stream, anim::Animation& animation)
+{
+    _ASSERT(animation.key_frame_count() == 0);
+
+    int bone_count = 0;
+    int key_frame_count = 0;
+    stream >> bone_count >> key_frame_count >> animation.m_rotation_interpolation;
+    if (!stream || key_frame_count <= 0)
+    {
+        return stream;
+    }
+
+    //the clip has to match the skeleton it's loaded against, and the channel count has to fit an int
+    if (bone_count != (int)animation.m_skeleton.bones.size() ||
+        (int64_t)key_frame_count * bone_count > std::numeric_limits<int>::max())
+    {
+        stream.setstate(std::ios::failbit);
+        return stream;
+    }
+
+    //the keyframes go straight into their final storage, the times are only added once everything has been read
+    //so a truncated file leaves the animation empty, adding them one at a time works out the key interval
+    animation.reserve(key_frame_count, bone_count);
+    std::vector<float> times(key_frame_count);
+    file::read_array(stream, std::span<float>(times));
+    int value_count = key_frame_count * bone_count;
+    file::read_array(stream, std::span<anim::Translation>(animation.translations(), value_count));
+    file::read_array(stream, std::span<anim::Rotation>(animation.rotations(), value_count));
+    if (!stream)
+    {
+        return stream;
+    }
+    for (float time : times)
+    {
+        animation.m_key_times.add(time);
     }
+    return stream;
 }
\ No newline at end of file
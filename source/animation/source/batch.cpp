@@ -0,0 +1,93 @@
+#include "batch.h"
+
+#include "jobs/job_system.h"
+
+namespace anim
+{
+    namespace
+    {
+        template<typename Job>
+        void finish_pose(const Skeleton& skeleton, const Job& job)
+        {
+            calculate_global_transforms(skeleton, job.local_transforms, job.global_transforms);
+            if (!job.matrix_stack.empty())
+            {
+                calculate_matrices(job.global_transforms, job.matrix_stack);
+            }
+            if (!job.skinning_palette.empty())
+            {
+                calculate_skinning_matrices(skeleton, job.global_transforms, job.skinning_palette);
+            }
+        }
+
+        void evaluate_pose(const PoseJob& job)
+        {
+            _ASSERT(job.animation != nullptr);
+            if (job.retarget != nullptr)
+            {
+                //every bone is sampled through the map, then the bones the lod drops are put back to rest
+                PlaybackCursor cursor;
+                SamplePoint point = job.animation->find_sample_point(job.time, job.cursor != nullptr ? *job.cursor : cursor, job.loop);
+                job.retarget->sample(*job.animation, job.nearest_key ? point.nearest() : point, job.local_transforms);
+                if (job.bone_lods != nullptr)
+                {
+                    job.bone_lods->apply_rest_pose(job.bone_lod, job.local_transforms);
+                }
+                finish_pose(job.retarget->target(), job);
+                return;
+            }
+
+            if (job.bone_lods != nullptr || job.nearest_key)
+            {
+                SampleLod lod;
+                lod.nearest_key = job.nearest_key;
+                if (job.bone_lods != nullptr)
+                {
+                    lod.bones = job.bone_lods->animated_bones(job.bone_lod);
+                    job.bone_lods->apply_rest_pose(job.bone_lod, job.local_transforms);
+                }
+                PlaybackCursor cursor;
+                job.animation->get_pose(job.time, job.cursor != nullptr ? *job.cursor : cursor, lod, job.local_transforms, job.loop);
+            }
+            else if (job.cursor != nullptr)
+            {
+                job.animation->get_pose(job.time, *job.cursor, job.local_transforms, job.loop);
+            }
+            else
+            {
+                job.animation->get_pose(job.time, job.local_transforms, job.loop);
+            }
+
+            finish_pose(job.animation->skeleton(), job);
+        }
+
+        void evaluate_blend(const BlendJob& job)
+        {
+            _ASSERT(job.skeleton != nullptr);
+            blend_layers(job.layers, job.rest_pose, job.local_transforms);
+            finish_pose(*job.skeleton, job);
+        }
+    }
+
+    void evaluate_poses(std::span<const PoseJob> batch, jobs::JobSystem& job_system, int grain_size)
+    {
+        job_system.parallel_for(0, (int)batch.size(), grain_size, [batch](int begin, int end)
+            {
+                for (int i = begin; i < end; ++i)
+                {
+                    evaluate_pose(batch[i]);
+                }
+            });
+    }
+
+    void evaluate_blends(std::span<const BlendJob> batch, jobs::JobSystem& job_system, int grain_size)
+    {
+        job_system.parallel_for(0, (int)batch.size(), grain_size, [batch](int begin, int end)
+            {
+                for (int i = begin; i < end; ++i)
+                {
+                    evaluate_blend(batch[i]);
+                }
+            });
+    }
+}
\ No newline at end of file
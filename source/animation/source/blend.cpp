@@ -0,0 +1,231 @@
+#include "blend.h"
+
+#include "maths/wide.h"
+
+#include <algorithm>
+#include <array>
+
+namespace anim
+{
+    namespace
+    {
+        constexpr int g_width = geom::simd::native_width;
+        using Float = geom::FloatxN<g_width>;
+        using Vector3xN = geom::Vector3xN<g_width>;
+        using QuaternionxN = geom::QuaternionxN<g_width>;
+
+        //a layer's keyframes and how to combine them, found once before any bones are blended
+        struct PreparedLayer
+        {
+            const Translation* translations = nullptr;
+            const Rotation* rotations = nullptr;
+            const Translation* next_translations = nullptr;
+            const Rotation* next_rotations = nullptr;
+            bool interpolate = false;
+            Float t;
+            geom::RotationInterpolation method = geom::RotationInterpolation::Slerp;
+            float weight = 0.f;
+            const float* bone_mask = nullptr;
+            //additive layers only, either the reference pose or the first keyframe's channels
+            const Transform* reference_pose = nullptr;
+            const Translation* reference_translations = nullptr;
+            const Rotation* reference_rotations = nullptr;
+        };
+
+        PreparedLayer prepare(const BlendLayer& layer)
+        {
+            const Animation& animation = *layer.animation;
+            SamplePoint point = layer.cursor != nullptr
+                ? animation.find_sample_point(layer.time, *layer.cursor, layer.loop)
+                : animation.find_sample_point(layer.time, layer.loop);
+
+            PreparedLayer prepared;
+            prepared.translations = animation.key_frame_translations(point.key_frame).data();
+            prepared.rotations = animation.key_frame_rotations(point.key_frame).data();
+            prepared.next_translations = animation.key_frame_translations(point.next_key_frame).data();
+            prepared.next_rotations = animation.key_frame_rotations(point.next_key_frame).data();
+            prepared.interpolate = point.key_frame != point.next_key_frame;
+            prepared.t = Float::broadcast(point.t);
+            prepared.method = animation.rotation_interpolation();
+            prepared.weight = layer.weight;
+            prepared.bone_mask = layer.bone_mask.empty() ? nullptr : layer.bone_mask.data();
+            if (layer.mode == BlendMode::Additive)
+            {
+                prepared.reference_pose = layer.reference_pose.empty() ? nullptr : layer.reference_pose.data();
+                prepared.reference_translations = animation.key_frame_translations(0).data();
+                prepared.reference_rotations = animation.key_frame_rotations(0).data();
+            }
+            return prepared;
+        }
+
+        //false if the layer is masked out of every bone in the block, so it can be skipped
+        bool bone_weights(const PreparedLayer& layer, int bone, int lanes, Float& weights)
+        {
+            if (layer.bone_mask == nullptr)
+            {
+                weights = Float::broadcast(layer.weight);
+                return true;
+            }
+
+            //lanes past the final bone are left at zero weight
+            weights = Float::broadcast(0.f);
+            bool any = false;
+            for (int i = 0; i < lanes; ++i)
+            {
+                weights.lanes[i] = layer.weight * layer.bone_mask[bone + i];
+                any |= layer.bone_mask[bone + i] > 0.f;
+            }
+            return any;
+        }
+
+        void sample(const PreparedLayer& layer, int bone, int lanes, Vector3xN& translation, QuaternionxN& rotation)
+        {
+            translation = Vector3xN::load(layer.translations + bone, lanes);
+            rotation = QuaternionxN::load(layer.rotations + bone, lanes);
+            if (layer.interpolate)
+            {
+                translation = Vector3xN::interpolate(translation, Vector3xN::load(layer.next_translations + bone, lanes), layer.t);
+                rotation = QuaternionxN::interpolate(rotation, QuaternionxN::load(layer.next_rotations + bone, lanes), layer.t, layer.method);
+            }
+        }
+
+        //adds a weighted rotation to a sum, flipped to the sum's hemisphere as q and -q are the same rotation and would cancel out
+        void accumulate(QuaternionxN& sum, const QuaternionxN& rotation, const Float& weight)
+        {
+            sum = sum + rotation * Float::copysign(weight, QuaternionxN::dot(sum, rotation));
+        }
+    }
+
+    void blend_layers(std::span<const BlendLayer> layers, std::span<const Transform> rest_pose, std::span<Transform> out)
+    {
+        _ASSERT(layers.size() <= g_max_blend_layers);
+        _ASSERT(rest_pose.empty() || rest_pose.size() == out.size());
+
+        //layers with no weight are skipped entirely, so layers that are fading in or out cost nothing once faded
+        std::array<PreparedLayer, g_max_blend_layers> override_layers;
+        std::array<PreparedLayer, g_max_blend_layers> additive_layers;
+        int override_count = 0;
+        int additive_count = 0;
+        //weights only grow as layers are added, so once the unmasked layers reach one no bone needs the rest pose
+        float unmasked_weight = 0.f;
+        for (const BlendLayer& layer : layers)
+        {
+            _ASSERT(layer.animation != nullptr && layer.animation->bone_count() == (int)out.size());
+            _ASSERT(layer.bone_mask.empty() || layer.bone_mask.size() == out.size());
+            _ASSERT(layer.reference_pose.empty() || layer.reference_pose.size() == out.size());
+            if (layer.weight <= 0.f)
+            {
+                continue;
+            }
+
+            if (layer.mode == BlendMode::Override)
+            {
+                override_layers[override_count++] = prepare(layer);
+                unmasked_weight += layer.bone_mask.empty() ? layer.weight : 0.f;
+            }
+            else
+            {
+                additive_layers[additive_count++] = prepare(layer);
+            }
+        }
+
+        Float one = Float::broadcast(1.f);
+        Float zero = Float::broadcast(0.f);
+        QuaternionxN identity = QuaternionxN::broadcast(Rotation::identity());
+        int count = (int)out.size();
+        for (int bone = 0; bone < count; bone += g_width)
+        {
+            int lanes = std::min(g_width, count - bone);
+            Vector3xN translation;
+            QuaternionxN rotation;
+
+            //weighted average of the override layers
+            Vector3xN translation_sum = Vector3xN::broadcast(Translation::zero());
+            QuaternionxN rotation_sum = { zero, zero, zero, zero };
+            Float weight_sum = zero;
+            for (int i = 0; i < override_count; ++i)
+            {
+                Float weights;
+                if (!bone_weights(override_layers[i], bone, lanes, weights))
+                {
+                    continue;
+                }
+                sample(override_layers[i], bone, lanes, translation, rotation);
+                translation_sum = translation_sum + translation * weights;
+                accumulate(rotation_sum, rotation, weights);
+                weight_sum = weight_sum + weights;
+            }
+
+            //the rest pose makes up weights below one, and is all there is for bones no layer applies to
+            if (unmasked_weight < 1.f)
+            {
+                Float rest_weights = Float::max(one - weight_sum, zero);
+                if (!rest_pose.empty())
+                {
+                    translation = Vector3xN::load(rest_pose.data() + bone, &Transform::translation, lanes);
+                    rotation = QuaternionxN::load(rest_pose.data() + bone, &Transform::rotation, lanes);
+                }
+                else
+                {
+                    translation = Vector3xN::broadcast(Translation::zero());
+                    rotation = identity;
+                }
+                translation_sum = translation_sum + translation * rest_weights;
+                accumulate(rotation_sum, rotation, rest_weights);
+                weight_sum = weight_sum + rest_weights;
+            }
+
+            Vector3xN blended_translation = translation_sum * (one / weight_sum);
+            QuaternionxN blended_rotation = rotation_sum.normalized();
+
+            //additive layers apply their difference from the reference pose, scaled by weight, on top in the bone's local space
+            for (int i = 0; i < additive_count; ++i)
+            {
+                const PreparedLayer& layer = additive_layers[i];
+                Float weights;
+                if (!bone_weights(layer, bone, lanes, weights))
+                {
+                    continue;
+                }
+                sample(layer, bone, lanes, translation, rotation);
+
+                Vector3xN reference_translation;
+                QuaternionxN reference_rotation;
+                if (layer.reference_pose != nullptr)
+                {
+                    reference_translation = Vector3xN::load(layer.reference_pose + bone, &Transform::translation, lanes);
+                    reference_rotation = QuaternionxN::load(layer.reference_pose + bone, &Transform::rotation, lanes);
+                }
+                else
+                {
+                    reference_translation = Vector3xN::load(layer.reference_translations + bone, lanes);
+                    reference_rotation = QuaternionxN::load(layer.reference_rotations + bone, lanes);
+                }
+
+                blended_translation = blended_translation + (translation - reference_translation) * weights;
+                QuaternionxN difference = rotation * reference_rotation.inverse();
+                blended_rotation = QuaternionxN::interpolate(identity, difference, weights, layer.method) * blended_rotation;
+            }
+
+            blended_translation.store(out.data() + bone, &Transform::translation, lanes);
+            blended_rotation.store(out.data() + bone, &Transform::rotation, lanes);
+        }
+    }
+
+    float cross_fade_weight(float elapsed, float duration)
+    {
+        if (duration <= 0.f)
+        {
+            return 1.f;
+        }
+        float s = std::clamp(elapsed / duration, 0.f, 1.f);
+        return s * s * (3.f - 2.f * s);
+    }
+
+    void set_cross_fade(BlendLayer& from, BlendLayer& to, float elapsed, float duration)
+    {
+        float weight = cross_fade_weight(elapsed, duration);
+        from.weight = 1.f - weight;
+        to.weight = weight;
+    }
+}
\ No newline at end of file
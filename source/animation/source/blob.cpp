@@ -0,0 +1,95 @@
+#include "blob.h"
+
+#include <limits>
+
+namespace anim
+{
+    SkeletonBlob add_skeleton(file::BlobWriter& writer, const Skeleton& skeleton)
+    {
+        std::vector<int32_t> parents;
+        std::vector<Transform> global_transforms;
+        std::string names;
+        std::vector<uint32_t> name_ends;
+        for (const Skeleton::Bone& bone : skeleton.bones)
+        {
+            parents.push_back(bone.parent_index);
+            global_transforms.push_back(bone.global_transform);
+            names += bone.name;
+            name_ends.push_back((uint32_t)names.size());
+        }
+
+        SkeletonBlob blob;
+        blob.name = writer.add_string(skeleton.name);
+        blob.parents = writer.add_array(std::span<const int32_t>(parents));
+        blob.global_transforms = writer.add_array(std::span<const Transform>(global_transforms));
+        blob.names = writer.add_string(names);
+        blob.name_ends = writer.add_array(std::span<const uint32_t>(name_ends));
+        return blob;
+    }
+
+    bool read_skeleton(const file::BlobView& view, const SkeletonBlob& blob, Skeleton& out)
+    {
+        auto parents = view.array(blob.parents);
+        auto global_transforms = view.array(blob.global_transforms);
+        auto names = view.string(blob.names);
+        auto name_ends = view.array(blob.name_ends);
+        //parents are int16 once loaded, so larger skeletons can't be indexed
+        if (parents.empty() || parents.size() > (size_t)std::numeric_limits<int16_t>::max() ||
+            global_transforms.size() != parents.size() || name_ends.size() != parents.size() || name_ends.back() > names.size())
+        {
+            return false;
+        }
+
+        out.name = view.string(blob.name);
+        out.bones.resize(parents.size());
+        uint32_t name_start = 0;
+        for (size_t i = 0; i < parents.size(); ++i)
+        {
+            //-1 for a root, otherwise parents must come first, as update_hierarchy expects
+            if (parents[i] < -1 || parents[i] >= (int32_t)i || name_ends[i] < name_start)
+            {
+                return false;
+            }
+            out.bones[i] = { parents[i], global_transforms[i], std::string(names.substr(name_start, name_ends[i] - name_start)) };
+            name_start = name_ends[i];
+        }
+        out.update_hierarchy();
+        return true;
+    }
+
+    ClipBlob add_clip(file::BlobWriter& writer, const Animation& animation, std::string_view name)
+    {
+        const KeyTimes& key_times = animation.key_times();
+        size_t value_count = (size_t)animation.key_frame_count() * animation.bone_count();
+        const Translation* translations = animation.key_frame_count() > 0 ? animation.key_frame_translations(0).data() : nullptr;
+        const Rotation* rotations = animation.key_frame_count() > 0 ? animation.key_frame_rotations(0).data() : nullptr;
+
+        ClipBlob blob;
+        blob.name = writer.add_string(name);
+        blob.key_times = writer.add_array(key_times.times());
+        blob.translations = writer.add_array(std::span<const Translation>(translations, value_count));
+        blob.rotations = writer.add_array(std::span<const Rotation>(rotations, value_count));
+        blob.key_interval = key_times.interval();
+        blob.final_interval_trimmed = key_times.final_interval_trimmed();
+        blob.rotation_interpolation = (uint32_t)animation.rotation_interpolation();
+        return blob;
+    }
+
+    std::optional<Animation> view_clip(const file::BlobView& view, const ClipBlob& blob, const Skeleton& skeleton)
+    {
+        auto key_times = view.array(blob.key_times);
+        auto translations = view.array(blob.translations);
+        auto rotations = view.array(blob.rotations);
+        if (key_times.empty() || translations.size() != key_times.size() * skeleton.bones.size() || rotations.size() != translations.size())
+        {
+            return std::nullopt;
+        }
+
+        return Animation::borrow(
+            skeleton,
+            KeyTimes::borrow(key_times, blob.key_interval, blob.final_interval_trimmed != 0),
+            translations,
+            rotations,
+            (geom::RotationInterpolation)blob.rotation_interpolation);
+    }
+}
\ No newline at end of file
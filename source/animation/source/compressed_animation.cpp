@@ -0,0 +1,646 @@
+#include "compressed_animation.h"
+
+#include "maths/geometry.h"
+#include "maths/wide.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace anim
+{
+    namespace
+    {
+        //the smallest three components of a unit quaternion lie within +-1 / sqrt(2)
+        constexpr float g_rotation_component_range = 0.70710678f;
+        constexpr float g_rotation_component_scale = 32767.f;
+        constexpr float g_translation_component_scale = 65535.f;
+
+        //longest run of keyframes a track can drop between two keys, this bounds the cost of compression
+        //as every keyframe in a run is measured again each time it grows
+        constexpr int g_max_key_span = 64;
+
+        uint16_t quantise(float value, float scale)
+        {
+            return (uint16_t)std::clamp(roundf(value * scale), 0.f, scale);
+        }
+
+        //the same interpolation sampling uses, the scalar quaternion's slerp takes a different path and is less accurate
+        Rotation interpolate_rotation(const Rotation& q1, const Rotation& q2, float t, geom::RotationInterpolation method)
+        {
+            using QuaternionxN = geom::QuaternionxN<geom::simd::native_width>;
+            Rotation result;
+            QuaternionxN::interpolate(QuaternionxN::load(&q1, 1), QuaternionxN::load(&q2, 1), geom::FloatxN<geom::simd::native_width>::broadcast(t), method)
+                .store(&result, 1);
+            return result;
+        }
+
+        //largest distance between the points at shell distance along each axis of the two transforms
+        float shell_error(const Transform& lossy, const Transform& raw, float shell_distance)
+        {
+            float error_squared = 0.f;
+            for (geom::Vector3 axis : { geom::Vector3::unit_x(), geom::Vector3::unit_y(), geom::Vector3::unit_z() })
+            {
+                geom::Vector3 point = axis * shell_distance;
+                geom::Vector3 difference = (lossy.translation + lossy.rotation * point) - (raw.translation + raw.rotation * point);
+                error_squared = fmaxf(error_squared, difference.magnitude_squared());
+            }
+            return sqrtf(error_squared);
+        }
+    }
+
+    class CompressedAnimation::Compressor
+    {
+    public:
+        Compressor(const Animation& source, const CompressionSettings& settings, CompressedAnimation& result)
+            : m_source(source)
+            , m_settings(settings)
+            , m_result(result)
+            , m_frame_count(source.key_frame_count())
+            , m_bone_count(source.bone_count())
+        {
+        }
+
+        void run()
+        {
+            const Skeleton& skeleton = m_source.skeleton();
+            _ASSERT(m_frame_count > 0 && m_frame_count <= 65535);
+
+            //bones below each bone, parents always come before their children
+            m_descendants.resize(m_bone_count);
+            for (int bone = m_bone_count - 1; bone >= 0; --bone)
+            {
+                int parent = skeleton.bones[bone].parent_index;
+                if (parent == -1)
+                {
+                    continue;
+                }
+                auto& descendants = m_descendants[parent];
+                descendants.push_back(bone);
+                descendants.insert(descendants.end(), m_descendants[bone].begin(), m_descendants[bone].end());
+            }
+            for (auto& descendants : m_descendants)
+            {
+                std::sort(descendants.begin(), descendants.end());
+            }
+
+            //start from every keyframe of every track quantised, the most accurate state compression can reach
+            m_ranges.resize(m_bone_count);
+            m_full_precision_translations.resize(m_bone_count);
+            m_raw.resize(m_frame_count * m_bone_count);
+            m_lossy.resize(m_frame_count * m_bone_count);
+            for (int bone = 0; bone < m_bone_count; ++bone)
+            {
+                TranslationRange& range = m_ranges[bone];
+                Translation max = m_source.key_frame_translations(0)[bone];
+                range.min = max;
+                for (int frame = 0; frame < m_frame_count; ++frame)
+                {
+                    Translation translation = m_source.key_frame_translations(frame)[bone];
+                    range.min = { fminf(range.min.x, translation.x), fminf(range.min.y, translation.y), fminf(range.min.z, translation.z) };
+                    max = { fmaxf(max.x, translation.x), fmaxf(max.y, translation.y), fmaxf(max.z, translation.z) };
+                }
+                range.extent = max - range.min;
+
+                //quantisation of the track alone shouldn't take more than half the error budget
+                m_full_precision_translations[bone] =
+                    fmaxf(range.extent.x, fmaxf(range.extent.y, range.extent.z)) / g_translation_component_scale > 0.5f * m_settings.error_threshold;
+
+                for (int frame = 0; frame < m_frame_count; ++frame)
+                {
+                    raw_local(frame, bone) = { m_source.key_frame_translations(frame)[bone], m_source.key_frame_rotations(frame)[bone] };
+                    lossy_local(frame, bone) = { translation_key(frame, bone), rotation_key(frame, bone) };
+                }
+            }
+
+            m_raw_model.resize(m_frame_count * m_bone_count);
+            m_lossy_model.resize(m_frame_count * m_bone_count);
+            m_lossy_error.resize(m_frame_count * m_bone_count);
+            for (int frame = 0; frame < m_frame_count; ++frame)
+            {
+                for (int bone = 0; bone < m_bone_count; ++bone)
+                {
+                    int parent = skeleton.bones[bone].parent_index;
+                    model(m_raw_model, frame, bone) = parent == -1 ? raw_local(frame, bone) : model(m_raw_model, frame, parent) * raw_local(frame, bone);
+                }
+                for (int bone = 0; bone < m_bone_count; ++bone)
+                {
+                    update_lossy_model(frame, bone);
+                }
+            }
+
+            m_result.m_rotation_tracks.resize(m_bone_count);
+            m_result.m_translation_tracks.resize(m_bone_count);
+            m_candidate.resize(m_frame_count);
+            m_scratch.resize(m_bone_count);
+            for (int bone = 0; bone < m_bone_count; ++bone)
+            {
+                compress_track(bone, true);
+                compress_track(bone, false);
+            }
+        }
+
+    private:
+        Transform& raw_local(int frame, int bone) { return m_raw[frame * m_bone_count + bone]; }
+        Transform& lossy_local(int frame, int bone) { return m_lossy[frame * m_bone_count + bone]; }
+        Transform& model(std::vector<Transform>& transforms, int frame, int bone) { return transforms[frame * m_bone_count + bone]; }
+
+        //the values an animated track's key would be decoded to
+        Rotation rotation_key(int frame, int bone)
+        {
+            return unpack(pack(raw_local(frame, bone).rotation));
+        }
+
+        Translation translation_key(int frame, int bone)
+        {
+            const Translation& raw = raw_local(frame, bone).translation;
+            return m_full_precision_translations[bone] ? raw : unpack(pack(raw, m_ranges[bone]), m_ranges[bone]);
+        }
+
+        //model transform and error of the bone, its parent must be up to date
+        void update_lossy_model(int frame, int bone)
+        {
+            int parent = m_source.skeleton().bones[bone].parent_index;
+            model(m_lossy_model, frame, bone) = parent == -1 ? lossy_local(frame, bone) : model(m_lossy_model, frame, parent) * lossy_local(frame, bone);
+            m_lossy_error[frame * m_bone_count + bone] = shell_error(model(m_lossy_model, frame, bone), model(m_raw_model, frame, bone), m_settings.shell_distance);
+        }
+
+        //whether replacing the bone's local transforms over the frames keeps every bone below within the threshold
+        //a bone already over the threshold, from quantisation alone, only needs to get no worse
+        bool within_threshold(int bone, int begin_frame, int end_frame)
+        {
+            const Skeleton& skeleton = m_source.skeleton();
+            int parent = skeleton.bones[bone].parent_index;
+            for (int frame = begin_frame; frame < end_frame; ++frame)
+            {
+                const float* errors = m_lossy_error.data() + frame * m_bone_count;
+                auto within = [&](int i, const Transform& lossy)
+                {
+                    return shell_error(lossy, model(m_raw_model, frame, i), m_settings.shell_distance) <= fmaxf(m_settings.error_threshold, errors[i]);
+                };
+
+                m_scratch[bone] = parent == -1 ? m_candidate[frame] : model(m_lossy_model, frame, parent) * m_candidate[frame];
+                if (!within(bone, m_scratch[bone]))
+                {
+                    return false;
+                }
+                for (int descendant : m_descendants[bone])
+                {
+                    //the descendants are in order, so each one's parent is this bone or a descendant already in the scratch
+                    m_scratch[descendant] = m_scratch[skeleton.bones[descendant].parent_index] * lossy_local(frame, descendant);
+                    if (!within(descendant, m_scratch[descendant]))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void accept(int bone, int begin_frame, int end_frame)
+        {
+            for (int frame = begin_frame; frame < end_frame; ++frame)
+            {
+                lossy_local(frame, bone) = m_candidate[frame];
+                update_lossy_model(frame, bone);
+                for (int descendant : m_descendants[bone])
+                {
+                    update_lossy_model(frame, descendant);
+                }
+            }
+        }
+
+        //the candidate for a frame is the bone's current local transform with one of its tracks replaced
+        void set_candidate(int bone, int frame, const Rotation& rotation)
+        {
+            m_candidate[frame] = { lossy_local(frame, bone).translation, rotation };
+        }
+
+        void set_candidate(int bone, int frame, const Translation& translation)
+        {
+            m_candidate[frame] = { translation, lossy_local(frame, bone).rotation };
+        }
+
+        void compress_track(int bone, bool rotation)
+        {
+            Track& track = rotation ? m_result.m_rotation_tracks[bone] : m_result.m_translation_tracks[bone];
+            const TranslationRange& range = m_ranges[bone];
+            bool full_precision = !rotation && m_full_precision_translations[bone];
+
+            //constant, then identity if that is also close enough
+            auto set_constant = [&](const Transform& value)
+            {
+                for (int frame = 0; frame < m_frame_count; ++frame)
+                {
+                    if (rotation)
+                    {
+                        set_candidate(bone, frame, value.rotation);
+                    }
+                    else
+                    {
+                        set_candidate(bone, frame, value.translation);
+                    }
+                }
+            };
+            const Transform& first = raw_local(0, bone);
+            set_constant(first);
+            if (within_threshold(bone, 0, m_frame_count))
+            {
+                set_constant({ Translation::zero(), Rotation::identity() });
+                if (within_threshold(bone, 0, m_frame_count))
+                {
+                    track.type = TrackType::Identity;
+                }
+                else
+                {
+                    set_constant(first);
+                    track.type = TrackType::Constant;
+                    if (rotation)
+                    {
+                        track.value = (uint32_t)m_result.m_constant_rotations.size();
+                        m_result.m_constant_rotations.push_back(first.rotation);
+                    }
+                    else
+                    {
+                        track.value = (uint32_t)m_result.m_constant_translations.size();
+                        m_result.m_constant_translations.push_back(first.translation);
+                    }
+                }
+                accept(bone, 0, m_frame_count);
+                return;
+            }
+
+            //animated, the value at a frame between two kept keys is what sampling will interpolate
+            const KeyTimes& times = m_source.key_times();
+            auto set_interpolated = [&](int key_frame, int next_key_frame)
+            {
+                for (int frame = key_frame + 1; frame < next_key_frame; ++frame)
+                {
+                    float t = key_fraction(times[frame], times[key_frame], times[next_key_frame]);
+                    if (rotation)
+                    {
+                        set_candidate(bone, frame, interpolate_rotation(
+                            rotation_key(key_frame, bone), rotation_key(next_key_frame, bone), t, m_source.rotation_interpolation()));
+                    }
+                    else
+                    {
+                        set_candidate(bone, frame, Translation::interpolate(
+                            translation_key(key_frame, bone), translation_key(next_key_frame, bone), t));
+                    }
+                }
+            };
+
+            std::vector<uint16_t>& key_frames =
+                rotation ? m_result.m_rotation_key_frames :
+                full_precision ? m_result.m_full_precision_translation_key_frames :
+                m_result.m_translation_key_frames;
+            track.type = full_precision ? TrackType::AnimatedFullPrecision : TrackType::Animated;
+            track.first_key = (uint32_t)key_frames.size();
+            if (!rotation && !full_precision)
+            {
+                track.value = (uint32_t)m_result.m_translation_ranges.size();
+                m_result.m_translation_ranges.push_back(range);
+            }
+
+            //extend each run of dropped keyframes for as long as the error allows
+            auto add_key = [&](int frame)
+            {
+                key_frames.push_back((uint16_t)frame);
+                if (rotation)
+                {
+                    m_result.m_rotation_keys.push_back(pack(raw_local(frame, bone).rotation));
+                }
+                else if (full_precision)
+                {
+                    m_result.m_full_precision_translation_keys.push_back(raw_local(frame, bone).translation);
+                }
+                else
+                {
+                    m_result.m_translation_keys.push_back(pack(raw_local(frame, bone).translation, range));
+                }
+            };
+            add_key(0);
+            int key_frame = 0;
+            while (key_frame < m_frame_count - 1)
+            {
+                int next_key_frame = key_frame + 1;
+                while (next_key_frame + 1 < m_frame_count && next_key_frame + 1 - key_frame <= g_max_key_span)
+                {
+                    set_interpolated(key_frame, next_key_frame + 1);
+                    if (!within_threshold(bone, key_frame + 1, next_key_frame + 1))
+                    {
+                        break;
+                    }
+                    ++next_key_frame;
+                }
+
+                set_interpolated(key_frame, next_key_frame);
+                accept(bone, key_frame + 1, next_key_frame);
+                add_key(next_key_frame);
+                key_frame = next_key_frame;
+            }
+            track.key_count = (uint16_t)(key_frames.size() - track.first_key);
+
+            track.first_segment = (uint32_t)m_result.m_segment_keys.size();
+            add_segment_keys({ key_frames.data() + track.first_key, track.key_count }, m_frame_count, m_result.m_segment_keys);
+        }
+
+        const Animation& m_source;
+        const CompressionSettings& m_settings;
+        CompressedAnimation& m_result;
+        int m_frame_count;
+        int m_bone_count;
+
+        std::vector<std::vector<int>> m_descendants;
+        std::vector<TranslationRange> m_ranges;
+        std::vector<bool> m_full_precision_translations;
+        //local and model space transforms of every bone at every frame, indexed by frame then bone
+        std::vector<Transform> m_raw;
+        std::vector<Transform> m_lossy;
+        std::vector<Transform> m_raw_model;
+        std::vector<Transform> m_lossy_model;
+        std::vector<float> m_lossy_error;
+        //the local transforms of the bone being compressed for each frame, and the model transforms below it for one frame
+        std::vector<Transform> m_candidate;
+        std::vector<Transform> m_scratch;
+    };
+
+    CompressedAnimation::CompressedAnimation(const Animation& source, const CompressionSettings& settings)
+        : m_skeleton(source.skeleton())
+        , m_key_times(source.key_times())
+        , m_rotation_interpolation(source.rotation_interpolation())
+    {
+        Compressor(source, settings, *this).run();
+
+        m_constant_rotations.shrink_to_fit();
+        m_constant_translations.shrink_to_fit();
+        m_translation_ranges.shrink_to_fit();
+        m_rotation_key_frames.shrink_to_fit();
+        m_translation_key_frames.shrink_to_fit();
+        m_full_precision_translation_key_frames.shrink_to_fit();
+        m_segment_keys.shrink_to_fit();
+        m_rotation_keys.shrink_to_fit();
+        m_translation_keys.shrink_to_fit();
+        m_full_precision_translation_keys.shrink_to_fit();
+
+        //measure what sampling actually returns rather than trusting the compressor's bookkeeping
+        int bone_count = source.bone_count();
+        Pose raw;
+        raw.skeleton = &m_skeleton;
+        raw.local_transforms.resize(bone_count);
+        Pose compressed = raw;
+        std::vector<Transform> raw_model(bone_count);
+        std::vector<Transform> compressed_model(bone_count);
+        for (int frame = 0; frame < m_key_times.count(); ++frame)
+        {
+            source.get_pose(m_key_times[frame], raw.local_transforms);
+            get_pose(m_key_times[frame], compressed.local_transforms);
+            raw.get_global_transforms(raw_model);
+            compressed.get_global_transforms(compressed_model);
+            for (int bone = 0; bone < bone_count; ++bone)
+            {
+                m_max_error = fmaxf(m_max_error, shell_error(compressed_model[bone], raw_model[bone], settings.shell_distance));
+            }
+        }
+    }
+
+    Pose CompressedAnimation::get_pose(float time, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        return sample(time, m_key_times.find(time));
+    }
+
+    Pose CompressedAnimation::get_pose(float time, PlaybackCursor& cursor, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        return sample(time, cursor.key_frame);
+    }
+
+    void CompressedAnimation::get_pose(float time, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        sample(time, m_key_times.find(time), out);
+    }
+
+    void CompressedAnimation::get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        sample(time, cursor.key_frame, out);
+    }
+
+    size_t CompressedAnimation::memory_usage() const
+    {
+        return
+            m_key_times.memory_usage() +
+            (m_rotation_tracks.capacity() + m_translation_tracks.capacity()) * sizeof(Track) +
+            m_constant_rotations.capacity() * sizeof(Rotation) +
+            m_constant_translations.capacity() * sizeof(Translation) +
+            m_translation_ranges.capacity() * sizeof(TranslationRange) +
+            (m_rotation_key_frames.capacity() + m_translation_key_frames.capacity() + m_full_precision_translation_key_frames.capacity()) * sizeof(uint16_t) +
+            m_segment_keys.capacity() * sizeof(uint16_t) +
+            m_rotation_keys.capacity() * sizeof(PackedRotation) +
+            m_translation_keys.capacity() * sizeof(PackedTranslation) +
+            m_full_precision_translation_keys.capacity() * sizeof(Translation);
+    }
+
+    CompressedAnimation::Statistics CompressedAnimation::statistics() const
+    {
+        Statistics statistics;
+        for (auto* tracks : { &m_rotation_tracks, &m_translation_tracks })
+        {
+            for (const Track& track : *tracks)
+            {
+                switch (track.type)
+                {
+                case TrackType::Identity: ++statistics.identity_tracks; break;
+                case TrackType::Constant: ++statistics.constant_tracks; break;
+                case TrackType::Animated:
+                case TrackType::AnimatedFullPrecision:
+                    ++statistics.animated_tracks;
+                    statistics.animated_keys += track.key_count;
+                    statistics.source_keys += m_key_times.count();
+                    break;
+                }
+            }
+        }
+        return statistics;
+    }
+
+    CompressedAnimation::PackedRotation CompressedAnimation::pack(const Rotation& rotation)
+    {
+        float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (fabsf(components[i]) > fabsf(components[largest]))
+            {
+                largest = i;
+            }
+        }
+
+        //q and -q are the same rotation, so flip it to make the dropped component positive
+        float sign = components[largest] < 0.f ? -1.f : 1.f;
+        PackedRotation packed;
+        for (int i = 0, value = 0; i < 4; ++i)
+        {
+            if (i != largest)
+            {
+                float normalised = sign * components[i] / g_rotation_component_range * 0.5f + 0.5f;
+                packed.values[value++] = quantise(normalised, g_rotation_component_scale);
+            }
+        }
+        packed.values[0] |= (uint16_t)((largest & 1) << 15);
+        packed.values[1] |= (uint16_t)((largest >> 1) << 15);
+        return packed;
+    }
+
+    Rotation CompressedAnimation::unpack(const PackedRotation& packed)
+    {
+        constexpr float scale = 2.f * g_rotation_component_range / g_rotation_component_scale;
+
+        int largest = (packed.values[0] >> 15) | ((packed.values[1] >> 15) << 1);
+        float a = (float)(packed.values[0] & 0x7fff) * scale - g_rotation_component_range;
+        float b = (float)(packed.values[1] & 0x7fff) * scale - g_rotation_component_range;
+        float c = (float)packed.values[2] * scale - g_rotation_component_range;
+        float d = sqrtf(fmaxf(1.f - a * a - b * b - c * c, 0.f));
+
+        //the stored components keep their order around the dropped one, a track's largest component rarely changes so this branch predicts well
+        switch (largest)
+        {
+        case 0: return { d, a, b, c };
+        case 1: return { a, d, b, c };
+        case 2: return { a, b, d, c };
+        default: return { a, b, c, d };
+        }
+    }
+
+    CompressedAnimation::PackedTranslation CompressedAnimation::pack(const Translation& translation, const TranslationRange& range)
+    {
+        auto component = [](float value, float min, float extent)
+        {
+            return extent > 0.f ? quantise((value - min) / extent, g_translation_component_scale) : (uint16_t)0;
+        };
+        return { {
+            component(translation.x, range.min.x, range.extent.x),
+            component(translation.y, range.min.y, range.extent.y),
+            component(translation.z, range.min.z, range.extent.z)
+        } };
+    }
+
+    Translation CompressedAnimation::unpack(const PackedTranslation& packed, const TranslationRange& range)
+    {
+        constexpr float scale = 1.f / g_translation_component_scale;
+        return {
+            range.min.x + range.extent.x * (packed.values[0] * scale),
+            range.min.y + range.extent.y * (packed.values[1] * scale),
+            range.min.z + range.extent.z * (packed.values[2] * scale)
+        };
+    }
+
+    float CompressedAnimation::wrap_time(float time, bool loop) const
+    {
+        //if loop is enabled then ensure time is within duration
+        return loop ? fmodf(time, duration()) : time;
+    }
+
+    void CompressedAnimation::sample(float time, int key_frame, std::span<Transform> out) const
+    {
+        _ASSERT(out.size() == m_rotation_tracks.size());
+
+        //decode a register's worth of bones at a time, then interpolate their rotations together as Pose::interpolate does
+        constexpr int width = geom::simd::native_width;
+        using QuaternionxN = geom::QuaternionxN<width>;
+
+        int count = (int)out.size();
+        for (int i = 0; i < count; i += width)
+        {
+            int lanes = std::min(width, count - i);
+            Rotation keys[width];
+            Rotation next_keys[width];
+            auto t = geom::FloatxN<width>::broadcast(0.f);
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                int bone = i + lane;
+                out[bone].translation = sample_translation(m_translation_tracks[bone], time, key_frame);
+                find_rotation_keys(m_rotation_tracks[bone], time, key_frame, keys[lane], next_keys[lane], t.lanes[lane]);
+            }
+
+            QuaternionxN::interpolate(QuaternionxN::load(keys, lanes), QuaternionxN::load(next_keys, lanes), t, m_rotation_interpolation)
+                .store(out.data() + i, &Transform::rotation, lanes);
+        }
+    }
+
+    Pose CompressedAnimation::sample(float time, int key_frame) const
+    {
+        Pose pose;
+        pose.skeleton = &m_skeleton;
+        pose.local_transforms.resize(m_rotation_tracks.size());
+        sample(time, key_frame, pose.local_transforms);
+        return pose;
+    }
+
+    float CompressedAnimation::key_fraction(float time, float key_time, float next_key_time)
+    {
+        return std::clamp((time - key_time) / (next_key_time - key_time), 0.f, 1.f);
+    }
+
+    void CompressedAnimation::find_rotation_keys(const Track& track, float time, int key_frame, Rotation& key, Rotation& next_key, float& t) const
+    {
+        //constant tracks and the final key interpolate between two copies of the value
+        t = 0.f;
+        switch (track.type)
+        {
+        case TrackType::Identity:
+            key = next_key = Rotation::identity();
+            return;
+        case TrackType::Constant:
+            key = next_key = m_constant_rotations[track.value];
+            return;
+        default:
+            break;
+        }
+
+        std::span<const uint16_t> key_frames(m_rotation_key_frames.data() + track.first_key, track.key_count);
+        const PackedRotation* keys = m_rotation_keys.data() + track.first_key;
+        int i = find_track_key(key_frames, m_segment_keys.data() + track.first_segment, key_frame);
+        key = unpack(keys[i]);
+        if (i + 1 == track.key_count)
+        {
+            next_key = key;
+            return;
+        }
+        next_key = unpack(keys[i + 1]);
+        t = key_fraction(time, m_key_times[key_frames[i]], m_key_times[key_frames[i + 1]]);
+    }
+
+    Translation CompressedAnimation::sample_translation(const Track& track, float time, int key_frame) const
+    {
+        switch (track.type)
+        {
+        case TrackType::Identity:
+            return Translation::zero();
+        case TrackType::Constant:
+            return m_constant_translations[track.value];
+        default:
+            break;
+        }
+
+        bool full_precision = track.type == TrackType::AnimatedFullPrecision;
+        std::span<const uint16_t> key_frames(
+            (full_precision ? m_full_precision_translation_key_frames : m_translation_key_frames).data() + track.first_key,
+            track.key_count);
+        int key = find_track_key(key_frames, m_segment_keys.data() + track.first_segment, key_frame);
+        int next_key = std::min(key + 1, track.key_count - 1);
+        float t = next_key == key ? 0.f : key_fraction(time, m_key_times[key_frames[key]], m_key_times[key_frames[next_key]]);
+        if (full_precision)
+        {
+            const Translation* keys = m_full_precision_translation_keys.data() + track.first_key;
+            return Translation::interpolate(keys[key], keys[next_key], t);
+        }
+
+        const PackedTranslation* keys = m_translation_keys.data() + track.first_key;
+        const TranslationRange& range = m_translation_ranges[track.value];
+        return Translation::interpolate(unpack(keys[key], range), unpack(keys[next_key], range), t);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "curve_animation.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace anim
+{
+    namespace
+    {
+        //value at time on the segment starting at knot i, knot_time gives the time of a knot
+        //tangents are finite differences of the neighbouring knots as they are unevenly spaced, one sided at the ends
+        template<typename Value, typename KnotTime>
+        Value evaluate_segment(const Value* knots, int knot_count, int i, KnotTime&& knot_time, float time)
+        {
+            if (i + 1 >= knot_count)
+            {
+                return knots[knot_count - 1];
+            }
+
+            int previous = std::max(i - 1, 0);
+            int next = std::min(i + 2, knot_count - 1);
+            float start = knot_time(i);
+            float end = knot_time(i + 1);
+            float duration = end - start;
+            float s = std::clamp((time - start) / duration, 0.f, 1.f);
+            float s2 = s * s;
+            float s3 = s2 * s;
+
+            //hermite basis, with the tangent terms scaled to the segment's duration and folded into weights of the knots
+            float h00 = 2.f * s3 - 3.f * s2 + 1.f;
+            float h10 = s3 - 2.f * s2 + s;
+            float h01 = -2.f * s3 + 3.f * s2;
+            float h11 = s3 - s2;
+            float k0 = h10 * duration / (end - knot_time(previous));
+            float k1 = h11 * duration / (knot_time(next) - start);
+            return knots[i] * (h00 - k1) + knots[i + 1] * (h01 + k0) + knots[previous] * -k0 + knots[next] * k1;
+        }
+
+        Translation finish(const Translation& translation)
+        {
+            return translation;
+        }
+
+        Rotation finish(const Rotation& rotation)
+        {
+            return rotation.normalized();
+        }
+
+        float fit_error(const Translation& fitted, const Translation& baked)
+        {
+            return (fitted - baked).magnitude();
+        }
+
+        float fit_error(const Rotation& fitted, const Rotation& baked)
+        {
+            //angle from the chord between the rotations, acos of their dot product loses precision for small angles
+            float sign = Rotation::dot(fitted, baked) < 0.f ? -1.f : 1.f;
+            Rotation difference = fitted + baked * -sign;
+            float chord = sqrtf(difference.mod_squared());
+            return 4.f * asinf(fminf(0.5f * chord, 1.f));
+        }
+
+        //knots are added at the baked keyframe furthest from the curve until every keyframe is within tolerance
+        //adding a knot only changes the curve over the two segments either side, so only their errors are updated
+        template<typename Value>
+        float fit_curve(const KeyTimes& times, std::span<const Value> baked, float tolerance, std::vector<uint16_t>& knot_frames, std::vector<Value>& knots)
+        {
+            int frame_count = (int)baked.size();
+            knot_frames = { 0 };
+            knots = { baked[0] };
+            std::vector<float> errors(frame_count);
+
+            auto update_errors = [&](int begin_frame, int end_frame)
+            {
+                auto knot_time = [&](int knot) { return times[knot_frames[knot]]; };
+                int knot = (int)(std::upper_bound(knot_frames.begin(), knot_frames.end(), begin_frame) - knot_frames.begin()) - 1;
+                for (int frame = begin_frame; frame < end_frame; ++frame)
+                {
+                    while (knot + 1 < (int)knot_frames.size() && knot_frames[knot + 1] <= frame)
+                    {
+                        ++knot;
+                    }
+                    Value fitted = evaluate_segment(knots.data(), (int)knots.size(), knot, knot_time, times[frame]);
+                    errors[frame] = fit_error(finish(fitted), baked[frame]);
+                }
+            };
+
+            update_errors(0, frame_count);
+            while (true)
+            {
+                int worst = (int)(std::max_element(errors.begin(), errors.end()) - errors.begin());
+                if (errors[worst] <= tolerance)
+                {
+                    return errors[worst];
+                }
+
+                //a knot's own error is only rounding, so with a tolerance below that it can't be improved on
+                int knot = (int)(std::upper_bound(knot_frames.begin(), knot_frames.end(), worst) - knot_frames.begin());
+                if (knot_frames[knot - 1] == worst)
+                {
+                    errors[worst] = 0.f;
+                    continue;
+                }
+                knot_frames.insert(knot_frames.begin() + knot, (uint16_t)worst);
+                knots.insert(knots.begin() + knot, baked[worst]);
+
+                int knot_count = (int)knot_frames.size();
+                int begin_frame = knot_frames[std::max(knot - 2, 0)];
+                int end_frame = knot + 2 < knot_count ? knot_frames[knot + 2] : frame_count;
+                update_errors(begin_frame, end_frame);
+            }
+        }
+    }
+
+    CurveAnimation::CurveAnimation(const Animation& source, const CurveFitSettings& settings)
+        : m_skeleton(source.skeleton())
+        , m_key_times(source.key_times())
+    {
+        int frame_count = m_key_times.count();
+        int bone_count = source.bone_count();
+        _ASSERT(frame_count > 0 && frame_count <= 65535);
+
+        m_translation_curves.resize(bone_count);
+        m_rotation_curves.resize(bone_count);
+        std::vector<Translation> baked_translations(frame_count);
+        std::vector<Rotation> baked_rotations(frame_count);
+        std::vector<uint16_t> knot_frames;
+        std::vector<Translation> translation_knots;
+        std::vector<Rotation> rotation_knots;
+
+        auto add_curve = [&](Curve& curve, std::vector<uint16_t>& all_knot_frames)
+        {
+            curve.knot_count = (uint16_t)knot_frames.size();
+            curve.first_knot = (uint32_t)all_knot_frames.size();
+            curve.first_segment = (uint32_t)m_segment_keys.size();
+            all_knot_frames.insert(all_knot_frames.end(), knot_frames.begin(), knot_frames.end());
+            add_segment_keys(knot_frames, frame_count, m_segment_keys);
+        };
+
+        for (int bone = 0; bone < bone_count; ++bone)
+        {
+            for (int frame = 0; frame < frame_count; ++frame)
+            {
+                baked_translations[frame] = source.key_frame_translations(frame)[bone];
+                baked_rotations[frame] = source.key_frame_rotations(frame)[bone];
+
+                //q and -q are the same rotation, keep neighbouring keyframes in the same hemisphere so the curve doesn't swing between them
+                if (frame > 0 && Rotation::dot(baked_rotations[frame], baked_rotations[frame - 1]) < 0.f)
+                {
+                    baked_rotations[frame] = baked_rotations[frame] * -1.f;
+                }
+            }
+
+            float translation_error = fit_curve<Translation>(m_key_times, baked_translations, settings.translation_tolerance, knot_frames, translation_knots);
+            add_curve(m_translation_curves[bone], m_translation_knot_frames);
+            m_translation_knots.insert(m_translation_knots.end(), translation_knots.begin(), translation_knots.end());
+
+            float rotation_error = fit_curve<Rotation>(m_key_times, baked_rotations, settings.rotation_tolerance, knot_frames, rotation_knots);
+            add_curve(m_rotation_curves[bone], m_rotation_knot_frames);
+            m_rotation_knots.insert(m_rotation_knots.end(), rotation_knots.begin(), rotation_knots.end());
+
+            m_max_translation_error = fmaxf(m_max_translation_error, translation_error);
+            m_max_rotation_error = fmaxf(m_max_rotation_error, rotation_error);
+        }
+
+        m_translation_knot_frames.shrink_to_fit();
+        m_rotation_knot_frames.shrink_to_fit();
+        m_translation_knots.shrink_to_fit();
+        m_rotation_knots.shrink_to_fit();
+        m_segment_keys.shrink_to_fit();
+    }
+
+    Pose CurveAnimation::get_pose(float time, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        return sample(time, m_key_times.find(time));
+    }
+
+    Pose CurveAnimation::get_pose(float time, PlaybackCursor& cursor, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        return sample(time, cursor.key_frame);
+    }
+
+    void CurveAnimation::get_pose(float time, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        sample(time, m_key_times.find(time), out);
+    }
+
+    void CurveAnimation::get_pose(float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop) const
+    {
+        time = wrap_time(time, loop);
+        cursor.key_frame = m_key_times.find(time, cursor.key_frame);
+        sample(time, cursor.key_frame, out);
+    }
+
+    size_t CurveAnimation::memory_usage() const
+    {
+        return
+            m_key_times.memory_usage() +
+            (m_translation_curves.capacity() + m_rotation_curves.capacity()) * sizeof(Curve) +
+            (m_translation_knot_frames.capacity() + m_rotation_knot_frames.capacity() + m_segment_keys.capacity()) * sizeof(uint16_t) +
+            m_translation_knots.capacity() * sizeof(Translation) +
+            m_rotation_knots.capacity() * sizeof(Rotation);
+    }
+
+    float CurveAnimation::wrap_time(float time, bool loop) const
+    {
+        //if loop is enabled then ensure time is within duration
+        return loop ? fmodf(time, duration()) : time;
+    }
+
+    void CurveAnimation::sample(float time, int key_frame, std::span<Transform> out) const
+    {
+        _ASSERT(out.size() == m_rotation_curves.size());
+        for (int bone = 0; bone < (int)out.size(); ++bone)
+        {
+            out[bone] = {
+                evaluate(m_translation_curves[bone], m_translation_knot_frames.data(), m_translation_knots.data(), time, key_frame),
+                finish(evaluate(m_rotation_curves[bone], m_rotation_knot_frames.data(), m_rotation_knots.data(), time, key_frame))
+            };
+        }
+    }
+
+    Pose CurveAnimation::sample(float time, int key_frame) const
+    {
+        Pose pose;
+        pose.skeleton = &m_skeleton;
+        pose.local_transforms.resize(m_rotation_curves.size());
+        sample(time, key_frame, pose.local_transforms);
+        return pose;
+    }
+
+    template<typename Value>
+    Value CurveAnimation::evaluate(const Curve& curve, const uint16_t* knot_frames, const Value* knots, float time, int key_frame) const
+    {
+        std::span<const uint16_t> curve_knot_frames(knot_frames + curve.first_knot, curve.knot_count);
+        int knot = find_track_key(curve_knot_frames, m_segment_keys.data() + curve.first_segment, key_frame);
+        auto knot_time = [&](int i) { return m_key_times[curve_knot_frames[i]]; };
+        return evaluate_segment(knots + curve.first_knot, curve.knot_count, knot, knot_time, time);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "key_times.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace anim
+{
+    KeyTimes KeyTimes::borrow(std::span<const float> times, float interval, bool final_interval_trimmed)
+    {
+        KeyTimes key_times;
+        key_times.m_borrowed = times;
+        key_times.m_interval = interval;
+        key_times.m_final_interval_trimmed = final_interval_trimmed;
+        return key_times;
+    }
+
+    void KeyTimes::add(float time)
+    {
+        _ASSERT(m_borrowed.empty());
+        _ASSERT(time > duration());
+        update_interval(time);
+        m_times.push_back(time);
+    }
+
+    void KeyTimes::update_interval(float time)
+    {
+        //the importer bakes keyframes at a fixed rate but trims the final one to the clip's duration,
+        //so a shorter final interval still counts as being on the grid
+        int key_count = count();
+        if (key_count == 0)
+        {
+            return;
+        }
+        if (key_count == 1)
+        {
+            m_interval = time - m_times[0];
+            return;
+        }
+        if (m_interval == 0.f)
+        {
+            return;
+        }
+
+        //compare against the grid rather than the previous interval so rounding can't accumulate
+        float expected = m_times[0] + key_count * m_interval;
+        bool on_grid = fabsf(time - expected) <= 0.01f * m_interval;
+        if (m_final_interval_trimmed || (!on_grid && time > expected))
+        {
+            m_interval = 0.f;
+        }
+        else if (!on_grid)
+        {
+            m_final_interval_trimmed = true;
+        }
+    }
+
+    int KeyTimes::find(float time) const
+    {
+        if (m_interval > 0.f)
+        {
+            //direct index, checked against the neighbouring keyframes as the key times were rounded differently to the division
+            //clamped in float first, converting a float outside int's range is undefined, a nan goes to -1 as well
+            float index = (time - times()[0]) / m_interval;
+            index = index > -1.f ? std::min(index, (float)times().size()) : -1.f;
+            return find(time, (int)index);
+        }
+        return search(time);
+    }
+
+    int KeyTimes::find(float time, int hint) const
+    {
+        std::span<const float> times = this->times();
+        int last = (int)times.size() - 1;
+        auto contains = [&](int i) { return times[i] <= time && (i == last || time < times[i + 1]); };
+
+        //the hint or the keyframe after it cover forward playback, anything else is a jump so search for it
+        if (hint >= 0 && hint <= last && contains(hint))
+        {
+            return hint;
+        }
+        if (hint >= -1 && hint < last && contains(hint + 1))
+        {
+            return hint + 1;
+        }
+        return search(time);
+    }
+
+    void add_segment_keys(std::span<const uint16_t> key_frames, int clip_key_frame_count, std::vector<uint16_t>& segment_keys)
+    {
+        //the first key is always the clip's first keyframe, so every segment has a key at or before its start
+        _ASSERT(!key_frames.empty() && key_frames[0] == 0);
+        int key = 0;
+        for (int segment_start = 0; segment_start < clip_key_frame_count; segment_start += g_segment_key_frames)
+        {
+            while (key + 1 < (int)key_frames.size() && key_frames[key + 1] <= segment_start)
+            {
+                ++key;
+            }
+            segment_keys.push_back((uint16_t)key);
+        }
+    }
+
+    int KeyTimes::search(float time) const
+    {
+        std::span<const float> times = this->times();
+        auto next = std::upper_bound(times.begin(), times.end(), time);
+        return std::max((int)(next - times.begin()) - 1, 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "lod.h"
+
+#include <algorithm>
+
+namespace anim
+{
+    BoneLods::BoneLods(const Skeleton& skeleton, int level_count)
+    {
+        _ASSERT(level_count > 0);
+        int bone_count = (int)skeleton.bones.size();
+
+        //height of each bone above the deepest leaf below it, found in reverse as parents always come before their children
+        std::vector<int> heights(bone_count, 0);
+        for (int bone = bone_count - 1; bone >= 0; --bone)
+        {
+            int parent = skeleton.bones[bone].parent_index;
+            if (parent == -1)
+            {
+                continue;
+            }
+            heights[parent] = std::max(heights[parent], heights[bone] + 1);
+        }
+
+        m_rest_pose.resize(bone_count);
+        for (int bone = 0; bone < bone_count; ++bone)
+        {
+            int parent = skeleton.bones[bone].parent_index;
+            const Transform& global = skeleton.bones[bone].global_transform;
+            m_rest_pose[bone] = parent == -1 ? global : skeleton.bones[parent].global_transform.inverse() * global;
+        }
+
+        //level n animates the bones at least n above a leaf, and every root whatever its height
+        auto add_ranges = [&](int level, bool animated)
+        {
+            for (int bone = 0; bone < bone_count;)
+            {
+                auto kept = [&](int i) { return (heights[i] >= level || skeleton.bones[i].parent_index == -1) == animated; };
+                if (!kept(bone))
+                {
+                    ++bone;
+                    continue;
+                }
+                int begin = bone;
+                while (bone < bone_count && kept(bone))
+                {
+                    ++bone;
+                }
+                m_ranges.push_back({ begin, bone });
+            }
+        };
+
+        for (int level = 0; level < level_count; ++level)
+        {
+            Level ranges;
+            ranges.first_animated = (int)m_ranges.size();
+            add_ranges(level, true);
+            ranges.animated_count = (int)m_ranges.size() - ranges.first_animated;
+            ranges.first_rest = (int)m_ranges.size();
+            add_ranges(level, false);
+            ranges.rest_count = (int)m_ranges.size() - ranges.first_rest;
+            for (int i = 0; i < ranges.animated_count; ++i)
+            {
+                const BoneRange& range = m_ranges[ranges.first_animated + i];
+                ranges.animated_bone_count += range.end - range.begin;
+            }
+            m_levels.push_back(ranges);
+        }
+    }
+
+    std::span<const BoneRange> BoneLods::animated_bones(int level) const
+    {
+        const Level& ranges = m_levels[level];
+        return { m_ranges.data() + ranges.first_animated, (size_t)ranges.animated_count };
+    }
+
+    std::span<const BoneRange> BoneLods::rest_bones(int level) const
+    {
+        const Level& ranges = m_levels[level];
+        return { m_ranges.data() + ranges.first_rest, (size_t)ranges.rest_count };
+    }
+
+    void BoneLods::apply_rest_pose(int level, std::span<Transform> local_transforms) const
+    {
+        _ASSERT(local_transforms.size() == m_rest_pose.size());
+        for (const BoneRange& range : rest_bones(level))
+        {
+            std::copy(m_rest_pose.begin() + range.begin, m_rest_pose.begin() + range.end, local_transforms.begin() + range.begin);
+        }
+    }
+
+    int select_lod(const LodSettings& settings, float distance)
+    {
+        _ASSERT(!settings.levels.empty());
+        int level = 0;
+        while (level + 1 < (int)settings.levels.size() && distance >= settings.levels[level + 1].distance)
+        {
+            ++level;
+        }
+        return level;
+    }
+
+    bool update_lod(const LodSettings& settings, float distance, LodState& state)
+    {
+        int level = select_lod(settings, distance);
+        if (level != state.level)
+        {
+            //keep any seeded offset so instances entering a level together still update on different frames
+            state.level = level;
+            state.frames_until_update %= settings.levels[level].update_interval;
+            return true;
+        }
+
+        if (state.frames_until_update > 0)
+        {
+            --state.frames_until_update;
+            return false;
+        }
+        state.frames_until_update = settings.levels[level].update_interval - 1;
+        return true;
+    }
+}
\ No newline at end of file
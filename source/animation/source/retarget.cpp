@@ -0,0 +1,273 @@
+#include "retarget.h"
+
+#include "maths/wide.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <string>
+#include <unordered_map>
+
+namespace anim
+{
+    namespace
+    {
+        //the name without any namespace or path prefix, in lower case
+        std::string matching_name(const std::string& name)
+        {
+            size_t prefix = name.find_last_of(":|");
+            std::string matching = name.substr(prefix == std::string::npos ? 0 : prefix + 1);
+            for (char& c : matching)
+            {
+                c = (char)tolower((unsigned char)c);
+            }
+            return matching;
+        }
+
+        //source bone of each target bone, -1 where there is none
+        std::vector<int> match_by_name(const Skeleton& source, const Skeleton& target)
+        {
+            std::unordered_map<std::string, int> source_bones;
+            for (int bone = 0; bone < (int)source.bones.size(); ++bone)
+            {
+                //a name used twice keeps its first bone, which is the one nearer the root
+                source_bones.emplace(matching_name(source.bones[bone].name), bone);
+            }
+
+            std::vector<int> matches(target.bones.size(), -1);
+            for (int bone = 0; bone < (int)target.bones.size(); ++bone)
+            {
+                auto found = source_bones.find(matching_name(target.bones[bone].name));
+                if (found != source_bones.end() && !target.bones[bone].name.empty())
+                {
+                    matches[bone] = found->second;
+                }
+            }
+            return matches;
+        }
+
+        std::vector<std::vector<int>> children(const Skeleton& skeleton)
+        {
+            //index bones.size() holds the roots
+            std::vector<std::vector<int>> children(skeleton.bones.size() + 1);
+            for (int bone = 0; bone < (int)skeleton.bones.size(); ++bone)
+            {
+                int parent = skeleton.bones[bone].parent_index;
+                children[parent == -1 ? skeleton.bones.size() : parent].push_back(bone);
+            }
+            return children;
+        }
+
+        std::vector<int> match_by_hierarchy(const Skeleton& source, const Skeleton& target)
+        {
+            auto source_children = children(source);
+            auto target_children = children(target);
+
+            //parents come before their children, so pairing each matched pair's children in bone order reaches every pair
+            std::vector<int> matches(target.bones.size(), -1);
+            auto match_children = [&](const std::vector<int>& source_bones, const std::vector<int>& target_bones)
+            {
+                size_t count = std::min(source_bones.size(), target_bones.size());
+                for (size_t i = 0; i < count; ++i)
+                {
+                    matches[target_bones[i]] = source_bones[i];
+                }
+            };
+            match_children(source_children.back(), target_children.back());
+            for (int bone = 0; bone < (int)target.bones.size(); ++bone)
+            {
+                if (matches[bone] != -1)
+                {
+                    match_children(source_children[matches[bone]], target_children[bone]);
+                }
+            }
+            return matches;
+        }
+
+        Transform bind_local_transform(const Skeleton& skeleton, int bone)
+        {
+            int parent = skeleton.bones[bone].parent_index;
+            const Transform& global = skeleton.bones[bone].global_transform;
+            return parent == -1 ? global : skeleton.bones[parent].global_transform.inverse() * global;
+        }
+
+        Rotation bind_parent_rotation(const Skeleton& skeleton, int bone)
+        {
+            int parent = skeleton.bones[bone].parent_index;
+            return parent == -1 ? Rotation::identity() : skeleton.bones[parent].global_transform.rotation;
+        }
+    }
+
+    RetargetMap::RetargetMap(const Skeleton& source, const Skeleton& target, BoneMatching matching)
+        : m_source(&source)
+        , m_target(&target)
+    {
+        std::vector<int> matches = matching == BoneMatching::Name ? match_by_name(source, target) : match_by_hierarchy(source, target);
+
+        //the target bone's local rotation is chosen so its global rotation moves from its bind pose as the source bone's does,
+        //target global = source global * inverse(source bind global) * target bind global
+        //which in the bones' parent spaces is parent_correction * source local * correction, and gives the target's bind pose from the source's
+        float source_length = 0.f;
+        float target_length = 0.f;
+        m_source_bones = matches;
+        for (int bone = 0; bone < (int)target.bones.size(); ++bone)
+        {
+            Transform target_bind = bind_local_transform(target, bone);
+            int source_bone = matches[bone];
+            if (source_bone == -1)
+            {
+                m_held_bones.push_back({ bone, target_bind });
+                continue;
+            }
+
+            BoneMapping& mapping = m_bones.emplace_back();
+            mapping.source_bone = source_bone;
+            mapping.target_bone = bone;
+            mapping.parent_correction = bind_parent_rotation(target, bone).inverse() * bind_parent_rotation(source, source_bone);
+            mapping.correction = source.bones[source_bone].global_transform.rotation.inverse() * target.bones[bone].global_transform.rotation;
+            mapping.source_bind_translation = bind_local_transform(source, source_bone).translation;
+            mapping.target_bind_translation = target_bind.translation;
+
+            //roots are left out as their translation is a position rather than a bone length
+            if (target.bones[bone].parent_index != -1 && source.bones[source_bone].parent_index != -1)
+            {
+                source_length += mapping.source_bind_translation.magnitude();
+                target_length += mapping.target_bind_translation.magnitude();
+            }
+        }
+        m_translation_scale = source_length > 0.f ? target_length / source_length : 1.f;
+
+        //source order, so blocks of the table read blocks of the clip's channels
+        std::stable_sort(m_bones.begin(), m_bones.end(), [](const BoneMapping& lhs, const BoneMapping& rhs) { return lhs.source_bone < rhs.source_bone; });
+    }
+
+    template<typename Gather>
+    void RetargetMap::retarget(Gather&& gather, std::span<Transform> out) const
+    {
+        //a register's worth of mapped bones at a time, gather fills in their source local transforms
+        //consecutive is set when the block's source bones follow on from each other, so they can be loaded as a block
+        constexpr int width = geom::simd::native_width;
+        using Vector3xN = geom::Vector3xN<width>;
+        using QuaternionxN = geom::QuaternionxN<width>;
+
+        auto scale = geom::FloatxN<width>::broadcast(m_translation_scale);
+        int count = (int)m_bones.size();
+        for (int i = 0; i < count; i += width)
+        {
+            int lanes = std::min(width, count - i);
+            const BoneMapping* bones = m_bones.data() + i;
+            bool consecutive = true;
+            for (int lane = 1; lane < lanes; ++lane)
+            {
+                consecutive &= bones[lane].source_bone == bones[0].source_bone + lane;
+            }
+            Vector3xN translation;
+            QuaternionxN rotation;
+            gather(bones, lanes, consecutive, translation, rotation);
+
+            QuaternionxN parent_correction = QuaternionxN::load(bones, &BoneMapping::parent_correction, lanes);
+            Vector3xN offset = translation - Vector3xN::load(bones, &BoneMapping::source_bind_translation, lanes);
+            translation = Vector3xN::load(bones, &BoneMapping::target_bind_translation, lanes) + parent_correction * (offset * scale);
+            rotation = parent_correction * rotation * QuaternionxN::load(bones, &BoneMapping::correction, lanes);
+
+            //written to the target bones as they're stored, the target's own order doesn't matter
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                Transform& target = out[bones[lane].target_bone];
+                target.translation = { translation.x.lanes[lane], translation.y.lanes[lane], translation.z.lanes[lane] };
+                target.rotation = { rotation.x.lanes[lane], rotation.y.lanes[lane], rotation.z.lanes[lane], rotation.w.lanes[lane] };
+            }
+        }
+
+        for (const HeldBone& held : m_held_bones)
+        {
+            out[held.target_bone] = held.bind;
+        }
+    }
+
+    void RetargetMap::apply(std::span<const Transform> source_local_transforms, std::span<Transform> out) const
+    {
+        _ASSERT(source_local_transforms.size() == m_source->bones.size());
+        _ASSERT(out.size() == m_source_bones.size());
+
+        retarget([&](const BoneMapping* bones, int lanes, bool consecutive, auto& translation, auto& rotation)
+            {
+                using Vector3xN = std::remove_reference_t<decltype(translation)>;
+                using QuaternionxN = std::remove_reference_t<decltype(rotation)>;
+
+                const Transform* source = source_local_transforms.data();
+                if (consecutive)
+                {
+                    translation = Vector3xN::load(source + bones[0].source_bone, &Transform::translation, lanes);
+                    rotation = QuaternionxN::load(source + bones[0].source_bone, &Transform::rotation, lanes);
+                    return;
+                }
+                translation = Vector3xN::broadcast(Translation::zero());
+                rotation = QuaternionxN::broadcast(Rotation::identity());
+                for (int lane = 0; lane < lanes; ++lane)
+                {
+                    translation.set_lane(lane, source[bones[lane].source_bone].translation);
+                    rotation.set_lane(lane, source[bones[lane].source_bone].rotation);
+                }
+            }, out);
+    }
+
+    void RetargetMap::get_pose(const Animation& animation, float time, std::span<Transform> out, bool loop) const
+    {
+        sample(animation, animation.find_sample_point(time, loop), out);
+    }
+
+    void RetargetMap::get_pose(const Animation& animation, float time, PlaybackCursor& cursor, std::span<Transform> out, bool loop) const
+    {
+        sample(animation, animation.find_sample_point(time, cursor, loop), out);
+    }
+
+    void RetargetMap::sample(const Animation& animation, const SamplePoint& point, std::span<Transform> out) const
+    {
+        _ASSERT(&animation.skeleton() == m_source);
+        _ASSERT(out.size() == m_source_bones.size());
+
+        auto translations = animation.key_frame_translations(point.key_frame);
+        auto rotations = animation.key_frame_rotations(point.key_frame);
+        auto next_translations = animation.key_frame_translations(point.next_key_frame);
+        auto next_rotations = animation.key_frame_rotations(point.next_key_frame);
+        geom::RotationInterpolation method = animation.rotation_interpolation();
+        bool interpolated = point.key_frame != point.next_key_frame;
+
+        retarget([&](const BoneMapping* bones, int lanes, bool consecutive, auto& translation, auto& rotation)
+            {
+                using Vector3xN = std::remove_reference_t<decltype(translation)>;
+                using QuaternionxN = std::remove_reference_t<decltype(rotation)>;
+
+                Vector3xN next_translation;
+                QuaternionxN next_rotation;
+                if (consecutive)
+                {
+                    int first = bones[0].source_bone;
+                    translation = Vector3xN::load(translations.data() + first, lanes);
+                    rotation = QuaternionxN::load(rotations.data() + first, lanes);
+                    next_translation = Vector3xN::load(next_translations.data() + first, lanes);
+                    next_rotation = QuaternionxN::load(next_rotations.data() + first, lanes);
+                }
+                else
+                {
+                    //lanes past the block's end stay zero and identity in both keyframes, so interpolating leaves them as they are
+                    translation = next_translation = Vector3xN::broadcast(Translation::zero());
+                    rotation = next_rotation = QuaternionxN::broadcast(Rotation::identity());
+                    for (int lane = 0; lane < lanes; ++lane)
+                    {
+                        int source_bone = bones[lane].source_bone;
+                        translation.set_lane(lane, translations[source_bone]);
+                        rotation.set_lane(lane, rotations[source_bone]);
+                        next_translation.set_lane(lane, next_translations[source_bone]);
+                        next_rotation.set_lane(lane, next_rotations[source_bone]);
+                    }
+                }
+                if (interpolated)
+                {
+                    auto t = decltype(translation.x)::broadcast(point.t);
+                    translation = Vector3xN::interpolate(translation, next_translation, t);
+                    rotation = QuaternionxN::interpolate(rotation, next_rotation, t, method);
+                }
+            }, out);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "sampling_cache.h"
+
+#include "jobs/job_system.h"
+
+#include <algorithm>
+#include <bit>
+#include <math.h>
+
+namespace anim
+{
+    SamplingCache::SamplingCache(float time_quantum)
+        : m_time_quantum(time_quantum)
+    {
+        m_slots.assign(64, -1);
+    }
+
+    void SamplingCache::begin_frame()
+    {
+        m_entries.clear();
+        std::fill(m_slots.begin(), m_slots.end(), -1);
+    }
+
+    int SamplingCache::request(const Animation& animation, float time, bool loop, const BoneLods* bone_lods, int bone_lod, bool nearest_key, const RetargetMap* retarget)
+    {
+        //wrap after rounding, a time just before the end can round up to the duration and entries are sampled without looping
+        if (m_time_quantum > 0.f)
+        {
+            time = roundf(time / m_time_quantum) * m_time_quantum;
+        }
+        if (loop)
+        {
+            time = fmodf(time, animation.duration());
+        }
+        //-0 equals 0 but hashes differently
+        time += 0.f;
+        if (bone_lods == nullptr)
+        {
+            bone_lod = 0;
+        }
+
+        size_t mask = m_slots.size() - 1;
+        for (size_t slot = hash(&animation, retarget, bone_lods, time, bone_lod, nearest_key) & mask;; slot = (slot + 1) & mask)
+        {
+            int index = m_slots[slot];
+            if (index == -1)
+            {
+                index = (int)m_entries.size();
+                Entry entry;
+                entry.animation = &animation;
+                entry.time = time;
+                entry.bone_lods = bone_lods;
+                entry.bone_lod = bone_lod;
+                entry.nearest_key = nearest_key;
+                entry.retarget = retarget;
+                entry.first_bone = index == 0 ? 0 : m_entries.back().first_bone + bone_count(m_entries.back());
+                m_entries.push_back(entry);
+                m_slots[slot] = index;
+                if (2 * m_entries.size() > m_slots.size())
+                {
+                    grow_slots();
+                }
+                return index;
+            }
+
+            const Entry& entry = m_entries[index];
+            //the level is only the same set of bones if it's a level of the same bone lods
+            if (entry.animation == &animation && entry.retarget == retarget && entry.bone_lods == bone_lods
+                && entry.time == time && entry.bone_lod == bone_lod && entry.nearest_key == nearest_key)
+            {
+                return index;
+            }
+        }
+    }
+
+    void SamplingCache::evaluate(jobs::JobSystem& job_system)
+    {
+        if (m_entries.empty())
+        {
+            return;
+        }
+
+        //the buffers only grow, and are sized once all the frame's entries are known so the spans handed to the jobs stay valid
+        const Entry& last = m_entries.back();
+        size_t total_bone_count = last.first_bone + bone_count(last);
+        if (m_local_transforms.size() < total_bone_count)
+        {
+            m_local_transforms.resize(total_bone_count);
+            m_global_transforms.resize(total_bone_count);
+            m_skinning_palettes.resize(total_bone_count);
+        }
+
+        m_jobs.clear();
+        for (const Entry& entry : m_entries)
+        {
+            size_t entry_bone_count = bone_count(entry);
+            PoseJob job;
+            job.animation = entry.animation;
+            job.time = entry.time;
+            job.loop = false;
+            job.local_transforms = { m_local_transforms.data() + entry.first_bone, entry_bone_count };
+            job.global_transforms = { m_global_transforms.data() + entry.first_bone, entry_bone_count };
+            job.skinning_palette = { m_skinning_palettes.data() + entry.first_bone, entry_bone_count };
+            job.bone_lods = entry.bone_lods;
+            job.bone_lod = entry.bone_lod;
+            job.nearest_key = entry.nearest_key;
+            job.retarget = entry.retarget;
+            m_jobs.push_back(job);
+        }
+        evaluate_poses(m_jobs, job_system);
+    }
+
+    std::span<const Transform> SamplingCache::local_transforms(int entry) const
+    {
+        const Entry& cached = m_entries[entry];
+        return { m_local_transforms.data() + cached.first_bone, (size_t)bone_count(cached) };
+    }
+
+    std::span<const Transform> SamplingCache::global_transforms(int entry) const
+    {
+        const Entry& cached = m_entries[entry];
+        return { m_global_transforms.data() + cached.first_bone, (size_t)bone_count(cached) };
+    }
+
+    std::span<const geom::Matrix44> SamplingCache::skinning_palette(int entry) const
+    {
+        const Entry& cached = m_entries[entry];
+        return { m_skinning_palettes.data() + cached.first_bone, (size_t)bone_count(cached) };
+    }
+
+    int SamplingCache::bone_count(const Entry& entry)
+    {
+        return entry.retarget != nullptr ? (int)entry.retarget->target().bones.size() : entry.animation->bone_count();
+    }
+
+    uint64_t SamplingCache::hash(const Animation* animation, const RetargetMap* retarget, const BoneLods* bone_lods, float time, int bone_lod, bool nearest_key)
+    {
+        //splitmix64 finaliser over the fields folded together
+        uint64_t fields = (uint64_t)std::bit_cast<uint32_t>(time) << 32 | (uint64_t)bone_lod << 1 | (nearest_key ? 1 : 0);
+        uint64_t pointers = (uint64_t)(uintptr_t)animation
+            ^ (uint64_t)(uintptr_t)retarget * 0xff51afd7ed558ccdull
+            ^ (uint64_t)(uintptr_t)bone_lods * 0xc4ceb9fe1a85ec53ull;
+        uint64_t value = pointers ^ (fields * 0x9e3779b97f4a7c15ull);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    void SamplingCache::grow_slots()
+    {
+        m_slots.assign(m_slots.size() * 2, -1);
+        size_t mask = m_slots.size() - 1;
+        for (int index = 0; index < (int)m_entries.size(); ++index)
+        {
+            const Entry& entry = m_entries[index];
+            size_t slot = hash(entry.animation, entry.retarget, entry.bone_lods, entry.time, entry.bone_lod, entry.nearest_key) & mask;
+            while (m_slots[slot] != -1)
+            {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = index;
+        }
+    }
+}
\ No newline at end of file
@@ -1,20 +1,114 @@
 #include "skeleton.h"
 
+#include "file/binary_serializer.h"
+
+#include <algorithm>
+#include <limits>
+
 namespace anim
 {
-    std::vector<geom::Matrix44> Skeleton::matrix_stack()
+    void Skeleton::update_hierarchy()
     {
-        std::vector<geom::Matrix44> matrices;
-        for (auto& bone : bones)
+        _ASSERT(bones.size() <= std::numeric_limits<int16_t>::max());
+        int bone_count = (int)bones.size();
+
+        bind_matrix_stack.resize(bones.size());
+        inv_matrix_stack.resize(bones.size());
+        for (int i = 0; i < bone_count; ++i)
         {
-            matrices.push_back(bone.global_transform.calculate_matrix());
+            bind_matrix_stack[i] = bones[i].global_transform.calculate_matrix();
+            inv_matrix_stack[i] = bind_matrix_stack[i].rigid_inverse();
+        }
+
+        parents.resize(bones.size());
+        std::vector<int> depths(bones.size());
+        bool sorted_by_depth = true;
+        for (int i = 0; i < bone_count; ++i)
+        {
+            int parent = bones[i].parent_index;
+            _ASSERT(parent < i);
+            parents[i] = (int16_t)parent;
+            depths[i] = parent == -1 ? 0 : depths[parent] + 1;
+            sorted_by_depth &= i == 0 || depths[i] >= depths[i - 1];
+        }
+
+        depth_levels.clear();
+        if (!sorted_by_depth)
+        {
+            return;
+        }
+        for (int i = 0; i < bone_count; ++i)
+        {
+            if (i == 0 || depths[i] != depths[i - 1])
+            {
+                depth_levels.push_back({ i, i });
+            }
+            depth_levels.back().end = i + 1;
         }
-        return matrices;
+    }
+
+    void Skeleton::matrix_stack(std::span<geom::Matrix44> out) const
+    {
+        _ASSERT(out.size() == bind_matrix_stack.size());
+        std::copy(bind_matrix_stack.begin(), bind_matrix_stack.end(), out.begin());
+    }
+
+    std::vector<int> reorder_bones(Skeleton& skeleton, BoneOrder order)
+    {
+        int bone_count = (int)skeleton.bones.size();
+        std::vector<std::vector<int>> children(bone_count);
+        std::vector<int> roots;
+        for (int i = 0; i < bone_count; ++i)
+        {
+            int parent = skeleton.bones[i].parent_index;
+            (parent == -1 ? roots : children[parent]).push_back(i);
+        }
+
+        //old index of each bone in the new order, children keep their original relative order
+        std::vector<int> sorted;
+        sorted.reserve(bone_count);
+        if (order == BoneOrder::BreadthFirst)
+        {
+            sorted = roots;
+            for (int i = 0; i < (int)sorted.size(); ++i)
+            {
+                sorted.insert(sorted.end(), children[sorted[i]].begin(), children[sorted[i]].end());
+            }
+        }
+        else
+        {
+            std::vector<int> stack(roots.rbegin(), roots.rend());
+            while (!stack.empty())
+            {
+                int bone = stack.back();
+                stack.pop_back();
+                sorted.push_back(bone);
+                stack.insert(stack.end(), children[bone].rbegin(), children[bone].rend());
+            }
+        }
+        _ASSERT((int)sorted.size() == bone_count);
+
+        std::vector<int> remap(bone_count);
+        for (int i = 0; i < bone_count; ++i)
+        {
+            remap[sorted[i]] = i;
+        }
+
+        std::vector<Skeleton::Bone> bones(bone_count);
+        for (int i = 0; i < bone_count; ++i)
+        {
+            bones[i] = skeleton.bones[sorted[i]];
+            bones[i].parent_index = bones[i].parent_index == -1 ? -1 : remap[bones[i].parent_index];
+        }
+        skeleton.bones = std::move(bones);
+        skeleton.update_hierarchy();
+        return remap;
     }
 
     bool Skeleton::equivalent(const Skeleton& lhs, const Skeleton& rhs)
     {
-        if (lhs.name == rhs.name)
+        //same name, same hierarchy and same bind pose
+        if (lhs.name != rhs.name)
         {
             return false;
         }
@@ -22,7 +116,7 @@ namespace anim
         {
             return false;
         }
-        for (int i = 0; i < lhs.bones.size(); ++i)
+        for (int i = 0; i < (int)lhs.bones.size(); ++i)
         {
             auto& lhs_bone = lhs.bones[i];
             auto& rhs_bone = rhs.bones[i];
@@ -38,4 +132,40 @@ namespace anim
 
         return true;
     }
+}
+
+std::ofstream& operator<<(std::ofstream& stream, const anim::Skeleton& skeleton)
+{
+    stream << skeleton.name << (int)skeleton.bones.size();
+    for (const anim::Skeleton::Bone& bone : skeleton.bones)
+    {
+        stream << bone.parent_index << bone.global_transform << bone.name;
+    }
+    return stream;
+}
+
+std::ifstream& operator>>(std::ifstream& stream, anim::Skeleton& skeleton)
+{
+    int bone_count = 0;
+    stream >> skeleton.name >> bone_count;
+    if (!stream || bone_count < 0 || bone_count > std::numeric_limits<int16_t>::max())
+    {
+        stream.setstate(std::ios::failbit);
+        return stream;
+    }
+
+    skeleton.bones.resize(bone_count);
+    for (int i = 0; i < bone_count; ++i)
+    {
+        anim::Skeleton::Bone& bone = skeleton.bones[i];
+        stream >> bone.parent_index >> bone.global_transform >> bone.name;
+        //-1 for a root, otherwise parents must come first, as update_hierarchy expects
+        if (!stream || bone.parent_index < -1 || bone.parent_index >= i)
+        {
+            stream.setstate(std::ios::failbit);
+            return stream;
+        }
+    }
+    skeleton.update_hierarchy();
+    return stream;
 }
\ No newline at end of file
@@ -6,7 +6,18 @@ namespace anim
 {
     geom::Matrix44 Transform::calculate_matrix() const
     {
-        return geom::create_translation_matrix_44(translation) * geom::create_rotation_matrix_from_quaternion(rotation);
+        return geom::create_transform_matrix_44(translation, rotation);
+    }
+
+    geom::Matrix34 Transform::calculate_matrix_34() const
+    {
+        return geom::create_transform_matrix_34(translation, rotation);
+    }
+
+    Transform Transform::inverse() const
+    {
+        Rotation inverse_rotation = rotation.inverse();
+        return { inverse_rotation * -translation, inverse_rotation };
     }
 
     bool operator==(const Transform& lhs, const Transform& rhs)
@@ -15,4 +26,30 @@ namespace anim
             lhs.rotation == rhs.rotation &&
             lhs.translation == rhs.translation;
     }
+
+    Transform operator*(const Transform& lhs, const Transform& rhs)
+    {
+        return {
+            lhs.translation + lhs.rotation * rhs.translation,
+            lhs.rotation * rhs.rotation
+        };
+    }
+
+    void calculate_matrices(std::span<const Transform> transforms, std::span<geom::Matrix44> out)
+    {
+        _ASSERT(transforms.size() == out.size());
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            out[i] = transforms[i].calculate_matrix();
+        }
+    }
+
+    void calculate_matrices(std::span<const Transform> transforms, std::span<geom::Matrix34> out)
+    {
+        _ASSERT(transforms.size() == out.size());
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            out[i] = transforms[i].calculate_matrix_34();
+        }
+    }
 }
\ No newline at end of file
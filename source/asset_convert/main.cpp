@@ -0,0 +1,83 @@
+#include "fbx_wrapper.h"
+#include "native_content.h"
+
+#include "file/file_scanner.h"
+
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    //imports every fbx file under the directory that changed since it was last imported, so launch starts without the fbx sdk
+    int convert(const std::filesystem::path& fbx_root, file::ImportCache& cache)
+    {
+        auto fbx_files = file::fbx_paths(fbx_root);
+        std::cout << "Converting " << fbx_files.size() << " files from " << fbx_root << "\n";
+
+        FBXManagerWrapper fbx_manager;
+        int failed_count = 0;
+        for (auto& fbx_file : fbx_files)
+        {
+            if (!cache.find(fbx_file).empty())
+            {
+                std::cout << fbx_file << ": unchanged\n";
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            FbxFileContent content = fbx_manager.load_file_content(fbx_file.string().c_str());
+            if (!content.skeleton || !cache.add(fbx_file, content.dependencies, [&](const std::filesystem::path& path) { return write_native_content(content, path); }))
+            {
+                std::cout << "Failed to convert " << fbx_file << "\n";
+                ++failed_count;
+                continue;
+            }
+            std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+            std::cout << fbx_file << ": " << content.vertices.size() << " vertices, " << content.skeleton->bones.size() << " bones, "
+                << content.animations.size() << " clips in " << time.count() << "ms\n";
+        }
+
+        cache.save();
+        return failed_count == 0 ? 0 : 1;
+    }
+
+    int evict(file::ImportCache& cache, uint64_t max_bytes)
+    {
+        auto stats = cache.evict(max_bytes);
+        cache.save();
+        std::cout << "Evicted " << stats.removed_entries << " entries and " << stats.removed_files << " files, "
+            << stats.removed_bytes << " bytes, " << stats.remaining_bytes << " bytes remain\n";
+        return 0;
+    }
+}
+
+//asset_convert [fbx directory]
+//  converts the fbx files into the import cache
+//asset_convert --evict [max megabytes]
+//  removes cached files whose fbx file is gone or changed, then the least recently used until the cache fits in max megabytes
+int main(int argc, char** argv)
+{
+    file::ImportCache cache = open_import_cache(fbx_import_settings_hash());
+
+    if (argc > 1 && std::string(argv[1]) == "--evict")
+    {
+        uint64_t max_bytes = UINT64_MAX;
+        if (argc > 2)
+        {
+            std::string_view arg = argv[2];
+            uint64_t max_megabytes = 0;
+            auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), max_megabytes);
+            if (error != std::errc() || end != arg.data() + arg.size() || max_megabytes > UINT64_MAX / (1024 * 1024))
+            {
+                std::cout << "usage: asset_convert --evict [max megabytes], got " << arg << "\n";
+                return 1;
+            }
+            max_bytes = max_megabytes * 1024 * 1024;
+        }
+        return evict(cache, max_bytes);
+    }
+    return convert(argc > 1 ? std::filesystem::path(argv[1]) : file::g_fbx_path, cache);
+}
\ No newline at end of file
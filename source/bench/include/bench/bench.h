@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    //stops the optimiser from discarding work whose result would otherwise be unused
+    void escape(const void* pointer);
+
+    template<typename T>
+    void do_not_optimise(const T& value) { escape(&value); }
+
+    struct Result
+    {
+        std::string name;
+        long long iterations;
+        double ns_per_iteration;
+    };
+
+    //runs func once to warm up, then times iterations calls and takes the fastest of several repeats
+    template<typename Func>
+    Result run(std::string name, long long iterations, Func&& func);
+
+    void print(const Result& result);
+    void print_speedup(const Result& baseline, const Result& result);
+
+    //command line options shared by the benchmark executables
+    //--json <path> saves the results, --compare <path> checks them against results saved by an earlier run
+    //--threshold <fraction> is how much slower than the baseline a benchmark may be before it is flagged
+    //--help, an unknown argument or a missing value prints the usage and exits with 1 rather than running the benchmarks
+    struct Options
+    {
+        std::string json_path;
+        std::string baseline_path;
+        double threshold = 0.1;
+    };
+    Options parse_options(int argc, char** argv);
+
+    //the results of one run of a benchmark executable
+    //context records how the run was built, e.g. the instruction set, so mismatched comparisons can be spotted
+    struct Report
+    {
+        std::map<std::string, std::string> context;
+        std::vector<Result> results;
+
+        //prints the result and keeps it for finish
+        void add(const Result& result);
+
+        //saves and compares as requested, the return value is the exit code, non zero when anything regressed
+        int finish(const Options& options) const;
+    };
+
+    void write_json(std::ostream& stream, const Report& report);
+    //reads json written by write_json, returns false if the file couldn't be parsed
+    bool read_json(std::istream& stream, Report& report);
+
+    //prints each benchmark against its baseline, returns the number of regressions
+    int compare(const Report& baseline, const Report& report, double threshold);
+
+    //inline definitions
+
+    template<typename Func>
+    Result run(std::string name, long long iterations, Func&& func)
+    {
+        using clock = std::chrono::steady_clock;
+        constexpr int repeats = 5;
+
+        func();
+
+        double best_ns = -1.0;
+        for (int repeat = 0; repeat < repeats; ++repeat)
+        {
+            auto start = clock::now();
+            for (long long i = 0; i < iterations; ++i)
+            {
+                func();
+            }
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+            if (best_ns < 0.0 || ns < best_ns)
+            {
+                best_ns = ns;
+            }
+        }
+
+        return { std::move(name), iterations, best_ns / (double)iterations };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "bench.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace bench
+{
+    namespace
+    {
+        void write_string(std::ostream& stream, const std::string& value)
+        {
+            stream << '"';
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    stream << '\\';
+                }
+                stream << c;
+            }
+            stream << '"';
+        }
+
+        //reads the subset of json that write_json produces, objects, arrays, strings and numbers
+        class JsonReader
+        {
+        public:
+            JsonReader(std::string text) : m_text(std::move(text)) {}
+
+            bool failed() const { return m_failed; }
+
+            //consumes the character if it is next, ignoring whitespace
+            bool accept(char c)
+            {
+                skip_whitespace();
+                if (m_position < m_text.size() && m_text[m_position] == c)
+                {
+                    ++m_position;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!accept(c))
+                {
+                    m_failed = true;
+                }
+            }
+
+            std::string read_string()
+            {
+                std::string result;
+                expect('"');
+                while (!m_failed && m_position < m_text.size() && m_text[m_position] != '"')
+                {
+                    if (m_text[m_position] == '\\')
+                    {
+                        ++m_position;
+                    }
+                    if (m_position < m_text.size())
+                    {
+                        result += m_text[m_position++];
+                    }
+                }
+                expect('"');
+                return result;
+            }
+
+            double read_number()
+            {
+                skip_whitespace();
+                const char* start = m_text.c_str() + m_position;
+                char* end = nullptr;
+                double result = strtod(start, &end);
+                if (end == start)
+                {
+                    m_failed = true;
+                }
+                m_position += end - start;
+                return result;
+            }
+
+            //calls read_member with each key in an object, the value must be consumed by read_member
+            template<typename ReadMember>
+            void read_object(ReadMember&& read_member)
+            {
+                expect('{');
+                if (accept('}'))
+                {
+                    return;
+                }
+                do
+                {
+                    std::string key = read_string();
+                    expect(':');
+                    read_member(key);
+                } while (!m_failed && accept(','));
+                expect('}');
+            }
+
+            template<typename ReadElement>
+            void read_array(ReadElement&& read_element)
+            {
+                expect('[');
+                if (accept(']'))
+                {
+                    return;
+                }
+                do
+                {
+                    read_element();
+                } while (!m_failed && accept(','));
+                expect(']');
+            }
+
+        private:
+            void skip_whitespace()
+            {
+                while (m_position < m_text.size() && isspace((unsigned char)m_text[m_position]))
+                {
+                    ++m_position;
+                }
+            }
+
+            std::string m_text;
+            size_t m_position = 0;
+            bool m_failed = false;
+        };
+    }
+
+    //defined out of line so the compiler has to assume the pointed to value is read
+    void escape(const void* pointer)
+    {
+#if defined(__GNUC__)
+        //an empty asm that takes the pointer and clobbers memory, so the value has to be in memory and may be read
+        asm volatile("" : : "r"(pointer) : "memory");
+#else
+        //a volatile store and load can't be removed, and the pointer escapes through them
+        static const void* volatile s_sink;
+        s_sink = pointer;
+        (void)s_sink;
+#endif
+    }
+
+    void print(const Result& result)
+    {
+        std::cout << result.name << ": " << result.ns_per_iteration << " ns/iteration (" << result.iterations << " iterations)\n";
+    }
+
+    void print_speedup(const Result& baseline, const Result& result)
+    {
+        std::cout << result.name << " vs " << baseline.name << ": " << baseline.ns_per_iteration / result.ns_per_iteration << "x\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            bool has_value = i + 1 < argc;
+            if (argument == "--json" && has_value)
+            {
+                options.json_path = argv[++i];
+            }
+            else if (argument == "--compare" && has_value)
+            {
+                options.baseline_path = argv[++i];
+            }
+            else if (argument == "--threshold" && has_value)
+            {
+                options.threshold = atof(argv[++i]);
+            }
+            else
+            {
+                if (argument != "--help")
+                {
+                    std::cout << "unknown argument or missing value: " << argument << "\n";
+                }
+                std::cout << "usage: " << argv[0] << " [--json <path>] [--compare <baseline path>] [--threshold <fraction>]\n";
+                std::exit(1);
+            }
+        }
+        return options;
+    }
+
+    void Report::add(const Result& result)
+    {
+        print(result);
+        results.push_back(result);
+    }
+
+    int Report::finish(const Options& options) const
+    {
+        if (!options.json_path.empty())
+        {
+            std::ofstream stream(options.json_path);
+            write_json(stream, *this);
+            std::cout << "results written to " << options.json_path << "\n";
+        }
+
+        if (options.baseline_path.empty())
+        {
+            return 0;
+        }
+
+        std::ifstream stream(options.baseline_path);
+        Report baseline;
+        if (!stream || !read_json(stream, baseline))
+        {
+            std::cout << "couldn't read baseline " << options.baseline_path << "\n";
+            return 1;
+        }
+        return compare(baseline, *this, options.threshold) == 0 ? 0 : 1;
+    }
+
+    void write_json(std::ostream& stream, const Report& report)
+    {
+        stream << std::setprecision(9);
+        stream << "{\n    \"context\": {";
+        const char* separator = "\n";
+        for (auto& [key, value] : report.context)
+        {
+            stream << separator << "        ";
+            write_string(stream, key);
+            stream << ": ";
+            write_string(stream, value);
+            separator = ",\n";
+        }
+        stream << "\n    },\n    \"results\": [";
+        separator = "\n";
+        for (auto& result : report.results)
+        {
+            stream << separator << "        { \"name\": ";
+            write_string(stream, result.name);
+            stream << ", \"iterations\": " << result.iterations << ", \"ns_per_iteration\": " << result.ns_per_iteration << " }";
+            separator = ",\n";
+        }
+        stream << "\n    ]\n}\n";
+    }
+
+    bool read_json(std::istream& stream, Report& report)
+    {
+        std::stringstream text;
+        text << stream.rdbuf();
+        JsonReader reader(text.str());
+
+        reader.read_object([&](const std::string& key)
+            {
+                if (key == "context")
+                {
+                    reader.read_object([&](const std::string& context_key) { report.context[context_key] = reader.read_string(); });
+                }
+                else if (key == "results")
+                {
+                    reader.read_array([&]()
+                        {
+                            Result result;
+                            reader.read_object([&](const std::string& result_key)
+                                {
+                                    if (result_key == "name")
+                                    {
+                                        result.name = reader.read_string();
+                                    }
+                                    else if (result_key == "iterations")
+                                    {
+                                        result.iterations = (long long)reader.read_number();
+                                    }
+                                    else
+                                    {
+                                        result.ns_per_iteration = reader.read_number();
+                                    }
+                                });
+                            report.results.push_back(std::move(result));
+                        });
+                }
+                else
+                {
+                    reader.expect('?');
+                }
+            });
+
+        return !reader.failed();
+    }
+
+    int compare(const Report& baseline, const Report& report, double threshold)
+    {
+        for (auto& [key, value] : report.context)
+        {
+            auto it = baseline.context.find(key);
+            if (it != baseline.context.end() && it->second != value)
+            {
+                std::cout << "warning: baseline " << key << " is " << it->second << " but this run's is " << value << "\n";
+            }
+        }
+
+        int regressions = 0;
+        std::cout << "comparison against baseline, regressions are more than " << threshold * 100.0 << "% slower:\n";
+        for (auto& result : report.results)
+        {
+            const Result* previous = nullptr;
+            for (auto& baseline_result : baseline.results)
+            {
+                if (baseline_result.name == result.name)
+                {
+                    previous = &baseline_result;
+                    break;
+                }
+            }
+
+            if (!previous)
+            {
+                std::cout << "  " << result.name << ": not in baseline\n";
+                continue;
+            }
+
+            double change = result.ns_per_iteration / previous->ns_per_iteration - 1.0;
+            bool regressed = change > threshold;
+            regressions += regressed ? 1 : 0;
+            std::cout << "  " << result.name << ": " << previous->ns_per_iteration << " -> " << result.ns_per_iteration << " ns/iteration ("
+                << std::showpos << change * 100.0 << std::noshowpos << "%)" << (regressed ? " REGRESSION" : "") << "\n";
+        }
+
+        std::cout << regressions << " regression(s)\n";
+        return regressions;
+    }
+}
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <type_traits>
 
 #include <map>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -13,6 +16,30 @@ namespace file
 {
     std::ofstream open_for_write_binary(const std::filesystem::path& path);
     std::ifstream open_for_read_binary(const std::filesystem::path& path);
+
+    //written at the start of a file, the tag says what the file holds and the version which layout it was written with
+    //readers check both so a file from an older build is rejected rather than misread
+    struct FileHeader
+    {
+        uint32_t tag;
+        uint32_t version;
+    };
+
+    //four characters as a tag, they read in order in the file
+    constexpr uint32_t make_tag(const char (&name)[5]);
+
+    void write_header(std::ofstream& stream, const FileHeader& header);
+    //false if the file doesn't start with the header or can't be read
+    bool read_header(std::ifstream& stream, const FileHeader& expected);
+
+    //values written as one block rather than one at a time, for arrays of trivially copyable values whose count is known
+    //the bytes are copied as they are in memory, padding included, so a padded type writes whatever its padding holds
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void write_array(std::ofstream& stream, std::span<const T> values);
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void read_array(std::ifstream& stream, std::span<T> values);
 }
 
 //serializing=========================================================
@@ -20,7 +47,8 @@ namespace file
 template<typename T>
 std::ofstream& operator<<(std::ofstream& stream, const T& value)
 {
-    static_assert(false, "Attempting to serialize a type that isn't serializable.");
+    //the condition depends on T so that it only fails when this overload is instantiated
+    static_assert(sizeof(T) == 0, "Attempting to serialize a type that isn't serializable.");
     return stream;
 }
 
@@ -40,6 +68,14 @@ std::ofstream& operator<<(std::ofstream& stream, const std::pair<First, Second>&
     return stream;
 }
 
+inline std::ofstream& operator<<(std::ofstream& stream, const std::string& string)
+{
+    int size = (int)string.size();
+    stream << size;
+    stream.write(string.data(), size);
+    return stream;
+}
+
 template<typename T>
 std::ofstream& operator<<(std::ofstream& stream, const std::vector<T>& vec)
 {
@@ -52,6 +88,18 @@ std::ofstream& operator<<(std::ofstream& stream, const std::vector<T>& vec)
     return stream;
 }
 
+//same layout as writing the elements one at a time, but in a single write
+//only for types without padding or several representations of a value, anything else, floats included, is written element by element
+template<typename T>
+requires (std::has_unique_object_representations_v<T> && !std::is_same_v<T, bool>)
+std::ofstream& operator<<(std::ofstream& stream, const std::vector<T>& vec)
+{
+    int size = vec.size();
+    stream << size;
+    file::write_array(stream, std::span<const T>(vec));
+    return stream;
+}
+
 template<typename T>
 std::ofstream& operator<<(std::ofstream& stream, const std::set<T>& set)
 {
@@ -93,7 +141,7 @@ std::ofstream& operator<<(std::ofstream& stream, const std::unordered_map<Key, V
 template<typename T>
 std::ifstream& operator>>(std::ifstream& stream, T& value)
 {
-    static_assert(false, "Attempting to deserialize a type that isn't deserializable.");
+    static_assert(sizeof(T) == 0, "Attempting to deserialize a type that isn't deserializable.");
     return stream;
 }
 
@@ -113,6 +161,15 @@ std::ifstream& operator>>(std::ifstream& stream, std::pair<First, Second>& pair)
     return stream;
 }
 
+inline std::ifstream& operator>>(std::ifstream& stream, std::string& string)
+{
+    int size;
+    stream >> size;
+    string.resize(size);
+    stream.read(string.data(), size);
+    return stream;
+}
+
 template<typename T>
 std::ifstream& operator>>(std::ifstream& stream, std::vector<T>& vec)
 {
@@ -127,6 +184,17 @@ std::ifstream& operator>>(std::ifstream& stream, std::vector<T>& vec)
     return stream;
 }
 
+template<typename T>
+requires (std::has_unique_object_representations_v<T> && !std::is_same_v<T, bool>)
+std::ifstream& operator>>(std::ifstream& stream, std::vector<T>& vec)
+{
+    int size;
+    stream >> size;
+    vec.resize(size);
+    file::read_array(stream, std::span<T>(vec));
+    return stream;
+}
+
 template<typename T>
 std::ifstream& operator>>(std::ifstream& stream, std::set<T>& set)
 {
@@ -169,4 +237,27 @@ std::ifstream& operator>>(std::ifstream& stream, std::unordered_map<Key, Value>&
         map.emplace(std::move(key), std::move(value));
     }
     return stream;
+}
+
+//inline definitions
+namespace file
+{
+    constexpr uint32_t make_tag(const char (&name)[5])
+    {
+        return uint32_t(uint8_t(name[0])) | uint32_t(uint8_t(name[1])) << 8 | uint32_t(uint8_t(name[2])) << 16 | uint32_t(uint8_t(name[3])) << 24;
+    }
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void write_array(std::ofstream& stream, std::span<const T> values)
+    {
+        stream.write(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+    }
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void read_array(std::ifstream& stream, std::span<T> values)
+    {
+        stream.read(reinterpret_cast<char*>(values.data()), values.size_bytes());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "binary_serializer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace file
+{
+    //sections start at multiples of this from the start of the blob, so arrays of simd friendly types can be used in place
+    constexpr size_t g_blob_alignment = 64;
+
+    //a section of count values at offset bytes from the start of the blob
+    //offsets rather than pointers so a blob can be used wherever it's loaded or mapped without fixing anything up
+    template<typename T>
+    struct BlobArray
+    {
+        uint64_t offset = 0;
+        uint64_t count = 0;
+    };
+
+    struct BlobHeader
+    {
+        FileHeader file;
+        //catches a blob written on a machine with the other byte order
+        uint32_t byte_order = 0x01020304;
+        uint32_t alignment = g_blob_alignment;
+        //bytes in the whole blob, including the header
+        uint64_t size = 0;
+        //offset of the root struct, which holds the BlobArrays of the other sections
+        uint64_t root = 0;
+    };
+
+    //builds a blob in memory, sections are appended and the header is filled in by set_root
+    //values must be trivially copyable and made of fixed size fields so a blob reads the same on any build
+    class BlobWriter
+    {
+    public:
+        explicit BlobWriter(const FileHeader& header);
+
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        BlobArray<T> add_array(std::span<const T> values);
+        //a string as chars, not null terminated
+        BlobArray<char> add_string(std::string_view string);
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        void set_root(const T& root);
+
+        std::span<const std::byte> bytes() const { return m_bytes; }
+        //replaces the file at path whole, false if it couldn't be written or replaced
+        bool save(const std::filesystem::path& path) const;
+
+    private:
+        uint64_t append(const void* data, size_t size);
+
+        std::vector<std::byte> m_bytes;
+    };
+
+    //a blob used in place, the header is checked once and each section is bounds and alignment checked as it's viewed
+    //the bytes must stay alive and unchanged while the view or anything viewed through it is used
+    class BlobView
+    {
+    public:
+        BlobView() = default;
+        //an invalid view if the bytes don't hold a whole blob with the expected header
+        BlobView(std::span<const std::byte> bytes, const FileHeader& expected);
+
+        bool valid() const { return !m_bytes.empty(); }
+        //null if the root isn't the type's size or isn't in the blob
+        template<typename T>
+        const T* root() const;
+        //empty if the section isn't within the blob or isn't aligned for the type
+        template<typename T>
+        std::span<const T> array(const BlobArray<T>& array) const;
+        std::string_view string(const BlobArray<char>& string) const;
+
+    private:
+        bool contains(uint64_t offset, uint64_t size, size_t alignment) const;
+
+        std::span<const std::byte> m_bytes;
+        uint64_t m_root = 0;
+    };
+}
+
+//inline definitions
+namespace file
+{
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    BlobArray<T> BlobWriter::add_array(std::span<const T> values)
+    {
+        return { append(values.data(), values.size_bytes()), values.size() };
+    }
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void BlobWriter::set_root(const T& root)
+    {
+        uint64_t offset = append(&root, sizeof(T));
+        BlobHeader* header = reinterpret_cast<BlobHeader*>(m_bytes.data());
+        header->root = offset;
+        header->size = m_bytes.size();
+    }
+
+    template<typename T>
+    const T* BlobView::root() const
+    {
+        return contains(m_root, sizeof(T), alignof(T)) ? reinterpret_cast<const T*>(m_bytes.data() + m_root) : nullptr;
+    }
+
+    template<typename T>
+    std::span<const T> BlobView::array(const BlobArray<T>& array) const
+    {
+        if (array.count == 0 || array.count > m_bytes.size() / sizeof(T) || !contains(array.offset, array.count * sizeof(T), alignof(T)))
+        {
+            return {};
+        }
+        return { reinterpret_cast<const T*>(m_bytes.data() + array.offset), (size_t)array.count };
+    }
+}
\ No newline at end of file
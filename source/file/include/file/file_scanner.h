@@ -6,5 +6,6 @@
 
 namespace file
 {
-    std::vector<std::filesystem::path> fbx_paths();
+    //sorted, so files are always loaded in the same order whatever order the file system lists them in
+    std::vector<std::filesystem::path> fbx_paths(const std::filesystem::path& directory = g_fbx_path);
 }
\ No newline at end of file
@@ -6,4 +6,6 @@ namespace file
 {
     inline std::filesystem::path g_assets_path = "../assets/";
     inline std::filesystem::path g_fbx_path = "../assets/fbx/";
+    //files converted from the fbx files, see ImportCache
+    inline std::filesystem::path g_import_cache_path = "../assets/cache/";
 }
\ No newline at end of file
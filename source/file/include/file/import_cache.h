@@ -0,0 +1,101 @@
+#pragma once
+
+#include "filepaths.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace file
+{
+    //files converted from source files, kept between runs so a source is only converted again when its content changes
+    //each entry records what its converted file was made from: the content of its source and of any files it depends on,
+    //and the converter's own key, which should cover the converter's version and any settings that change its output
+    //a change to any of them means the source is converted again, and the converted file's key hashes them all
+    //converted files are named after their key, so sources with the same content share one
+    //the manifest remembers the size and write time of each file it hashed, so files that haven't changed aren't hashed again
+    class ImportCache
+    {
+    public:
+        //extension is given to the converted files, the manifest is loaded from the directory if there is one
+        ImportCache(const std::filesystem::path& directory, const std::filesystem::path& extension, uint64_t converter_key);
+
+        //the converted file for the source if it's there and was converted from what the source and its dependencies hold now
+        //by a converter with the same key, empty if the source needs converting
+        std::filesystem::path find(const std::filesystem::path& source);
+        //calls write with where the source's converted file goes, bool(const std::filesystem::path&), and records the source
+        //and its dependencies as they are now if write returns true, so a failed write leaves nothing in the cache
+        //dependencies are any files other than the source that the conversion read
+        template<typename Write>
+        bool add(const std::filesystem::path& source, std::span<const std::filesystem::path> dependencies, Write&& write);
+
+        struct EvictionStats
+        {
+            int removed_entries = 0;
+            int removed_files = 0;
+            uint64_t removed_bytes = 0;
+            uint64_t remaining_bytes = 0;
+        };
+        //forgets sources that no longer exist or changed since they were converted and removes converted files nothing uses,
+        //then removes the least recently used until the converted files take at most max_bytes
+        EvictionStats evict(uint64_t max_bytes = UINT64_MAX);
+
+        //writes the manifest if anything changed since it was loaded or saved
+        bool save();
+
+    private:
+        //a file as it was when it was last hashed
+        struct FileState
+        {
+            std::string path;
+            uint64_t size = 0;
+            int64_t write_time = 0;
+            uint64_t hash = 0;
+        };
+        struct Entry
+        {
+            FileState source;
+            std::vector<FileState> dependencies;
+            //the key of the converter that made the converted file
+            uint64_t converter_key = 0;
+            uint64_t key = 0;
+            int64_t last_used = 0;
+        };
+
+        //the source and dependencies as they are now, starting from their recorded states so they're only hashed if they changed
+        //false if any of them can't be read
+        bool current_state(const std::filesystem::path& source, std::span<const std::filesystem::path> dependencies, Entry& entry);
+        //where the entry's converted file goes, creating the directory for it
+        std::filesystem::path destination(const Entry& entry);
+        void record(Entry entry);
+        //whether the converted file is there and the source, dependencies and converter are what it was made from
+        bool up_to_date(Entry& entry);
+        //false if the file can't be read, the recorded hash is reused if the size and write time match
+        bool update_state(FileState& state);
+        uint64_t key(const Entry& entry) const;
+        std::filesystem::path converted_path(uint64_t key) const;
+        static std::string manifest_key(const std::filesystem::path& path);
+        void load();
+
+        std::filesystem::path m_directory;
+        std::filesystem::path m_extension;
+        uint64_t m_converter_key = 0;
+        std::unordered_map<std::string, Entry> m_entries;
+        bool m_changed = false;
+    };
+
+    template<typename Write>
+    bool ImportCache::add(const std::filesystem::path& source, std::span<const std::filesystem::path> dependencies, Write&& write)
+    {
+        Entry entry;
+        if (!current_state(source, dependencies, entry) || !write(destination(entry)))
+        {
+            return false;
+        }
+        record(std::move(entry));
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace file
+{
+    //a file mapped read only into memory, pages are read from disk the first time they're touched
+    //and come from the os's file cache, so processes mapping the same file share one copy
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        //not open if the file doesn't exist, is empty or can't be mapped
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+        MappedFile(MappedFile&& other);
+        MappedFile& operator=(MappedFile&& other);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool is_open() const { return m_data != nullptr; }
+        //page aligned, so offsets into it keep their alignment
+        std::span<const std::byte> bytes() const { return { m_data, m_size }; }
+
+    private:
+        void unmap();
+
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+    };
+}
\ No newline at end of file
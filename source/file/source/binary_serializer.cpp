@@ -9,3 +9,15 @@ std::ofstream file::open_for_write_binary(const std::filesystem::path& path)
 {
     return std::ofstream(path, std::ios::binary | std::ios::out);
 }
+
+void file::write_header(std::ofstream& stream, const FileHeader& header)
+{
+    stream << header;
+}
+
+bool file::read_header(std::ifstream& stream, const FileHeader& expected)
+{
+    FileHeader header = {};
+    stream >> header;
+    return stream && header.tag == expected.tag && header.version == expected.version;
+}
@@ -0,0 +1,89 @@
+#include "blob.h"
+
+#include <cstring>
+
+namespace file
+{
+    BlobWriter::BlobWriter(const FileHeader& header)
+    {
+        BlobHeader blob_header;
+        blob_header.file = header;
+        append(&blob_header, sizeof(blob_header));
+    }
+
+    BlobArray<char> BlobWriter::add_string(std::string_view string)
+    {
+        return add_array(std::span<const char>(string.data(), string.size()));
+    }
+
+    uint64_t BlobWriter::append(const void* data, size_t size)
+    {
+        uint64_t offset = (m_bytes.size() + g_blob_alignment - 1) & ~uint64_t(g_blob_alignment - 1);
+        m_bytes.resize(offset + size);
+        if (size > 0)
+        {
+            memcpy(m_bytes.data() + offset, data, size);
+        }
+        return offset;
+    }
+
+    bool BlobWriter::save(const std::filesystem::path& path) const
+    {
+        //written beside the path and renamed over it, so a reader never sees a partly written file
+        //and anything that has the old file mapped keeps the old file's pages rather than having them truncated
+        std::filesystem::path temp_path = path;
+        temp_path += ".tmp";
+        std::ofstream stream = open_for_write_binary(temp_path);
+        write_array(stream, bytes());
+        stream.close();
+
+        std::error_code error;
+        if (!stream.fail())
+        {
+            std::filesystem::rename(temp_path, path, error);
+            if (!error)
+            {
+                return true;
+            }
+        }
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+
+    BlobView::BlobView(std::span<const std::byte> bytes, const FileHeader& expected)
+    {
+        BlobHeader header;
+        if (bytes.size() < sizeof(header))
+        {
+            return;
+        }
+        memcpy(&header, bytes.data(), sizeof(header));
+
+        //the sections are only aligned in memory if the blob itself is, which mapped files and heap blocks this size are
+        bool aligned = reinterpret_cast<uintptr_t>(bytes.data()) % alignof(BlobHeader) == 0;
+        if (!aligned
+            || header.file.tag != expected.tag
+            || header.file.version != expected.version
+            || header.byte_order != BlobHeader().byte_order
+            || header.alignment != g_blob_alignment
+            || header.size > bytes.size())
+        {
+            return;
+        }
+        m_bytes = bytes.first((size_t)header.size);
+        m_root = header.root;
+    }
+
+    std::string_view BlobView::string(const BlobArray<char>& string) const
+    {
+        std::span<const char> chars = array(string);
+        return { chars.data(), chars.size() };
+    }
+
+    bool BlobView::contains(uint64_t offset, uint64_t size, size_t alignment) const
+    {
+        return offset <= m_bytes.size()
+            && size <= m_bytes.size() - offset
+            && reinterpret_cast<uintptr_t>(m_bytes.data() + offset) % alignment == 0;
+    }
+}
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "file/file_scanner.h"
 
+#include <algorithm>
+
 namespace file
 {
-    std::vector<std::filesystem::path> fbx_paths()
+    std::vector<std::filesystem::path> fbx_paths(const std::filesystem::path& directory)
     {
         std::vector<std::filesystem::path> result;
 
         //iterate over all files in the fbx path and return any that have the .fbx extension
-        for (auto& dir_entry : std::filesystem::recursive_directory_iterator(g_fbx_path))
+        for (auto& dir_entry : std::filesystem::recursive_directory_iterator(directory))
         {
             //unsure if this has the correct case-sensitivity
             if (dir_entry.path().extension() == std::filesystem::path(".fbx"))
@@ -16,6 +18,7 @@ namespace file
             }
         }
 
+        std::sort(result.begin(), result.end());
         return result;
     }
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "hash.h"
+
+#include "mapped_file.h"
+
+#include <cstring>
+
+namespace file
+{
+    namespace
+    {
+        constexpr uint64_t g_prime_1 = 0x9e3779b185ebca87ull;
+        constexpr uint64_t g_prime_2 = 0xc2b2ae3d27d4eb4full;
+
+        constexpr uint64_t rotate_left(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        uint64_t read_word(const std::byte* bytes)
+        {
+            uint64_t word;
+            memcpy(&word, bytes, sizeof(word));
+            return word;
+        }
+
+        uint64_t mix_word(uint64_t lane, uint64_t word)
+        {
+            return rotate_left(lane + word * g_prime_2, 31) * g_prime_1;
+        }
+    }
+
+    uint64_t hash_bytes(std::span<const std::byte> bytes, uint64_t seed)
+    {
+        const std::byte* data = bytes.data();
+        size_t size = bytes.size();
+        size_t offset = 0;
+
+        //the lanes don't depend on each other, so their multiplies overlap
+        uint64_t lanes[4] = { seed + g_prime_1 + g_prime_2, seed + g_prime_2, seed, seed - g_prime_1 };
+        for (; offset + 32 <= size; offset += 32)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                lanes[lane] = mix_word(lanes[lane], read_word(data + offset + lane * 8));
+            }
+        }
+
+        uint64_t hash = hash_combine(seed, size);
+        for (uint64_t lane : lanes)
+        {
+            hash = hash_combine(hash, lane);
+        }
+        for (; offset + 8 <= size; offset += 8)
+        {
+            hash = hash_combine(hash, read_word(data + offset));
+        }
+        if (offset < size)
+        {
+            uint64_t tail = 0;
+            memcpy(&tail, data + offset, size - offset);
+            hash = hash_combine(hash, tail);
+        }
+        return hash;
+    }
+
+    std::optional<uint64_t> hash_file(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            return std::nullopt;
+        }
+        //empty files can't be mapped, and hash as no bytes
+        MappedFile mapped(path);
+        if (!mapped.is_open() && std::filesystem::file_size(path, error) != 0)
+        {
+            return std::nullopt;
+        }
+        return hash_bytes(mapped.bytes());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "import_cache.h"
+
+#include "binary_serializer.h"
+#include "hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unordered_set>
+
+namespace file
+{
+    namespace
+    {
+        constexpr FileHeader g_manifest_header = { make_tag("IMCA"), 3 };
+        const std::filesystem::path g_manifest_name = "manifest";
+
+        int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    ImportCache::ImportCache(const std::filesystem::path& directory, const std::filesystem::path& extension, uint64_t converter_key)
+        : m_directory(directory)
+        , m_extension(extension)
+        , m_converter_key(converter_key)
+    {
+        load();
+    }
+
+    std::filesystem::path ImportCache::find(const std::filesystem::path& source)
+    {
+        auto found = m_entries.find(manifest_key(source));
+        if (found == m_entries.end())
+        {
+            return {};
+        }
+
+        Entry& entry = found->second;
+        if (!up_to_date(entry))
+        {
+            return {};
+        }
+
+        entry.last_used = now();
+        m_changed = true;
+        return converted_path(entry.key);
+    }
+
+    bool ImportCache::current_state(const std::filesystem::path& source, std::span<const std::filesystem::path> dependencies, Entry& entry)
+    {
+        //start from what's known about the source and the dependencies it already had
+        auto found = m_entries.find(manifest_key(source));
+        const Entry* previous = found != m_entries.end() ? &found->second : nullptr;
+        entry.source = previous ? previous->source : FileState{ manifest_key(source) };
+        entry.dependencies.clear();
+        for (const auto& dependency : dependencies)
+        {
+            FileState state = { manifest_key(dependency) };
+            if (previous)
+            {
+                auto known = std::find_if(previous->dependencies.begin(), previous->dependencies.end(),
+                    [&](const FileState& known_state) { return known_state.path == state.path; });
+                state = known != previous->dependencies.end() ? *known : state;
+            }
+            entry.dependencies.push_back(std::move(state));
+        }
+        entry.converter_key = m_converter_key;
+
+        bool readable = update_state(entry.source);
+        for (FileState& dependency : entry.dependencies)
+        {
+            readable &= update_state(dependency);
+        }
+        return readable;
+    }
+
+    std::filesystem::path ImportCache::destination(const Entry& entry)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        return converted_path(key(entry));
+    }
+
+    void ImportCache::record(Entry entry)
+    {
+        entry.key = key(entry);
+        entry.last_used = now();
+        m_entries[entry.source.path] = std::move(entry);
+        m_changed = true;
+    }
+
+    ImportCache::EvictionStats ImportCache::evict(uint64_t max_bytes)
+    {
+        EvictionStats stats;
+
+        std::error_code error;
+        for (auto entry = m_entries.begin(); entry != m_entries.end();)
+        {
+            //sources that are gone or changed since they were converted would only be found again by converting them again
+            if (up_to_date(entry->second))
+            {
+                ++entry;
+                continue;
+            }
+            entry = m_entries.erase(entry);
+            ++stats.removed_entries;
+        }
+
+        //converted files in use, most recently used first
+        std::vector<const Entry*> entries;
+        for (const auto& [path, entry] : m_entries)
+        {
+            entries.push_back(&entry);
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry* lhs, const Entry* rhs) { return lhs->last_used > rhs->last_used; });
+
+        //keep the most recently used files while they fit, a key shared by several sources counts once at its latest use
+        std::unordered_set<uint64_t> kept_keys;
+        std::unordered_set<uint64_t> seen_keys;
+        for (const Entry* entry : entries)
+        {
+            if (!seen_keys.insert(entry->key).second)
+            {
+                continue;
+            }
+            uint64_t size = std::filesystem::file_size(converted_path(entry->key), error);
+            if (error || stats.remaining_bytes + size > max_bytes)
+            {
+                continue;
+            }
+            kept_keys.insert(entry->key);
+            stats.remaining_bytes += size;
+        }
+
+        for (auto entry = m_entries.begin(); entry != m_entries.end();)
+        {
+            if (kept_keys.contains(entry->second.key))
+            {
+                ++entry;
+                continue;
+            }
+            entry = m_entries.erase(entry);
+            ++stats.removed_entries;
+        }
+
+        //anything else with the extension is a file nothing uses, from a changed source or an older converter
+        if (std::filesystem::is_directory(m_directory, error))
+        {
+            for (const auto& dir_entry : std::filesystem::directory_iterator(m_directory))
+            {
+                const auto& path = dir_entry.path();
+                if (path.extension() != m_extension || kept_keys.contains(std::strtoull(path.stem().string().c_str(), nullptr, 16)))
+                {
+                    continue;
+                }
+                uint64_t size = dir_entry.file_size(error);
+                if (std::filesystem::remove(path, error))
+                {
+                    ++stats.removed_files;
+                    stats.removed_bytes += error ? 0 : size;
+                }
+            }
+        }
+
+        m_changed |= stats.removed_entries > 0;
+        return stats;
+    }
+
+    bool ImportCache::up_to_date(Entry& entry)
+    {
+        //the new states are kept whether or not they match, so touched but unchanged files and changed ones are only hashed once
+        bool readable = update_state(entry.source);
+        for (FileState& dependency : entry.dependencies)
+        {
+            readable &= update_state(dependency);
+        }
+        std::error_code error;
+        return readable
+            && entry.converter_key == m_converter_key
+            && key(entry) == entry.key
+            && std::filesystem::exists(converted_path(entry.key), error);
+    }
+
+    bool ImportCache::update_state(FileState& state)
+    {
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(state.path, error);
+        if (error)
+        {
+            return false;
+        }
+        int64_t write_time = std::filesystem::last_write_time(state.path, error).time_since_epoch().count();
+        if (error)
+        {
+            return false;
+        }
+        if (state.hash != 0 && size == state.size && write_time == state.write_time)
+        {
+            return true;
+        }
+
+        auto hash = hash_file(state.path);
+        if (!hash)
+        {
+            return false;
+        }
+        state = { state.path, size, write_time, *hash };
+        m_changed = true;
+        return true;
+    }
+
+    uint64_t ImportCache::key(const Entry& entry) const
+    {
+        uint64_t key = hash_combine(entry.converter_key, entry.source.hash);
+        for (const FileState& dependency : entry.dependencies)
+        {
+            key = hash_combine(key, dependency.hash);
+        }
+        return key;
+    }
+
+    std::filesystem::path ImportCache::converted_path(uint64_t key) const
+    {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+        return (m_directory / name).replace_extension(m_extension);
+    }
+
+    std::string ImportCache::manifest_key(const std::filesystem::path& path)
+    {
+        return path.lexically_normal().generic_string();
+    }
+
+    void ImportCache::load()
+    {
+        std::ifstream stream = open_for_read_binary(m_directory / g_manifest_name);
+        if (!read_header(stream, g_manifest_header))
+        {
+            return;
+        }
+
+        auto read_state = [&](FileState& state)
+        {
+            stream >> state.path >> state.size >> state.write_time >> state.hash;
+        };
+        int entry_count = 0;
+        stream >> entry_count;
+        for (int i = 0; i < entry_count && stream; ++i)
+        {
+            Entry entry;
+            int dependency_count = 0;
+            read_state(entry.source);
+            stream >> dependency_count;
+            entry.dependencies.resize(stream && dependency_count > 0 ? dependency_count : 0);
+            for (FileState& dependency : entry.dependencies)
+            {
+                read_state(dependency);
+            }
+            stream >> entry.converter_key >> entry.key >> entry.last_used;
+            if (stream)
+            {
+                m_entries[entry.source.path] = std::move(entry);
+            }
+        }
+    }
+
+    bool ImportCache::save()
+    {
+        if (!m_changed)
+        {
+            return true;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        std::ofstream stream = open_for_write_binary(m_directory / g_manifest_name);
+        write_header(stream, g_manifest_header);
+
+        auto write_state = [&](const FileState& state)
+        {
+            stream << state.path << state.size << state.write_time << state.hash;
+        };
+        stream << (int)m_entries.size();
+        for (const auto& [path, entry] : m_entries)
+        {
+            write_state(entry.source);
+            stream << (int)entry.dependencies.size();
+            for (const FileState& dependency : entry.dependencies)
+            {
+                write_state(dependency);
+            }
+            stream << entry.converter_key << entry.key << entry.last_used;
+        }
+
+        m_changed = !stream.good();
+        return stream.good();
+    }
+}
\ No newline at end of file
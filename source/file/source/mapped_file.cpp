@@ -0,0 +1,99 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace file
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            //the view keeps the mapping open, so neither handle is needed once it's mapped
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                m_size = m_data ? (size_t)size.QuadPart : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        int file = open(path.c_str(), O_RDONLY);
+        if (file == -1)
+        {
+            return;
+        }
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0)
+        {
+            //the mapping keeps the file open, so the descriptor isn't needed once it's mapped
+            void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<const std::byte*>(data);
+                m_size = (size_t)status.st_size;
+            }
+        }
+        close(file);
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other)
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other)
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+}
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "shader.h"
 #include "vertex_array.h"
 
+#include "alloc/arena.h"
+
+#include <optional>
 
 namespace graphics
 {
@@ -27,15 +30,21 @@ namespace graphics
             const VertexArray<VType>& vao,
             const geom::Matrix44& camera,
             const geom::Matrix44& world,
-            const std::vector<geom::Matrix44>& pose_matrix_stack,
-            const std::vector<geom::Matrix44>& inverse_matrix_stack);
+            std::span<const geom::Matrix44> skinning_palette);
     };
 
+    //debug geometry is collected between begin and end then drawn with a single draw call
+    //the vertices are built in an arena, so collecting them doesn't touch the heap
     class DebugShader : public Program
     {
     public:
         DebugShader();
 
+        //the arena must outlive the call to end, reserve_vertex_count avoids regrowing the vertices, 6 per point or line
+        void begin(alloc::Arena& arena, int reserve_vertex_count = 0);
+        //draws everything collected since begin
+        void end(const Camera& camera);
+
         void draw_point(
             const Camera& camera,
             const geom::Vector3& point,
@@ -54,15 +63,21 @@ namespace graphics
         struct VectorVertex
         {
             geom::Vector3 pos;
+            Colour colour;
 
             static void apply_attributes()
             {
                 glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VectorVertex), (void*)0);
                 glEnableVertexAttribArray(0);
+                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(VectorVertex), (void*)offsetof(VectorVertex, colour));
+                glEnableVertexAttribArray(1);
             }
         };
 
-        void draw(const geom::Matrix44& camera, const std::vector<VectorVertex>& vertices, Colour colour);
+        //two triangles, corners are in the order p1, p2, p3, p1, p3, p4
+        void add_quad(const geom::Vector3& p1, const geom::Vector3& p2, const geom::Vector3& p3, const geom::Vector3& p4, Colour colour);
+
+        std::optional<alloc::ArenaVector<VectorVertex>> m_vertices;
     };
 
 
@@ -114,14 +129,12 @@ namespace graphics
 
         "uniform mat4 camera;"
         "uniform mat4 world;"
+        //each bone's pose matrix times its inverse bind matrix, combined on the cpu
         "uniform mat4 bones[100];"
-        "uniform mat4 inv_bones[100];"
 
         "void main()"
         "{"
-        "mat4 bone_matrix = bones[bone];"
-        "mat4 inv_bone_matrix = inv_bones[bone];"
-        "gl_Position = camera * world * bone_matrix * inv_bone_matrix * vec4(aPos.x, aPos.y, aPos.z, 1.0);"
+        "gl_Position = camera * world * bones[bone] * vec4(aPos.x, aPos.y, aPos.z, 1.0);"
         "};";
     const char* skinned_mesh_fragment_shader =
         "#version 330 core\n"
@@ -141,14 +154,12 @@ namespace graphics
         const VertexArray<VType>& vao,
         const geom::Matrix44& camera,
         const geom::Matrix44& world,
-        const std::vector<geom::Matrix44>& pose_matrix_stack,
-        const std::vector<geom::Matrix44>& inverse_matrix_stack)
+        std::span<const geom::Matrix44> skinning_palette)
     {
         use();
         set_uniform("camera", camera);
         set_uniform("world", world);
-        set_uniform("bones", pose_matrix_stack);
-        set_uniform("inv_bones", inverse_matrix_stack);
+        set_uniform("bones", skinning_palette);
         vao.use();
 
         glDrawElements(GL_TRIANGLES, vao.num_indices(), GL_UNSIGNED_INT, nullptr);
@@ -159,9 +170,9 @@ namespace graphics
     const char* line_vertex_shader =
         "#version 330 core\n"
         "layout(location = 0) in vec3 aPos;"
+        "layout(location = 1) in vec4 colour;"
 
         "uniform mat4 camera;"
-        "uniform vec4 colour;"
         
         "out vec4 colour_internal;"
 
@@ -183,6 +194,28 @@ namespace graphics
         : Program(line_vertex_shader, line_fragment_shader)
     {}
 
+    void DebugShader::begin(alloc::Arena& arena, int reserve_vertex_count)
+    {
+        m_vertices.emplace(arena);
+        m_vertices->reserve(reserve_vertex_count);
+    }
+
+    void DebugShader::end(const Camera& camera)
+    {
+        _ASSERT(m_vertices.has_value());
+        if (!m_vertices->empty())
+        {
+            use();
+            set_uniform("camera", camera.calculate_camera_matrix());
+
+            VertexArray vao(VertexBuffer<VectorVertex>(*m_vertices, GL_STREAM_DRAW), nullptr, 0);
+            vao.use();
+
+            glDrawArrays(GL_TRIANGLES, 0, (int)m_vertices->size());
+        }
+        m_vertices.reset();
+    }
+
     void DebugShader::draw_point(
         const Camera& camera,
         const geom::Vector3& point,
@@ -191,16 +224,7 @@ namespace graphics
     {
         geom::Vector3 x_offset = 0.5f * size * geom::Vector3::cross(point - camera.translation, geom::Vector3::unit_y()).normalized();
         geom::Vector3 y_offset = 0.5f * size * geom::Vector3::cross(point - camera.translation, x_offset).normalized();
-        std::vector<VectorVertex> vertices;
-        vertices.reserve(6);
-        vertices.push_back({ point - x_offset - y_offset });
-        vertices.push_back({ point - x_offset + y_offset });
-        vertices.push_back({ point + x_offset + y_offset });
-        vertices.push_back({ point - x_offset - y_offset });
-        vertices.push_back({ point + x_offset + y_offset });
-        vertices.push_back({ point + x_offset - y_offset });
-
-        draw(camera.calculate_camera_matrix(), vertices, colour);
+        add_quad(point - x_offset - y_offset, point - x_offset + y_offset, point + x_offset + y_offset, point + x_offset - y_offset, colour);
     }
 
     void DebugShader::draw_line(
@@ -213,29 +237,18 @@ namespace graphics
         //each end is split in two, with each half offset perpendicular to the line and camera offset by thickness/2
         geom::Vector3 offset1 = 0.5f * thickness * geom::Vector3::cross(p1 - camera.translation, p2 - p1).normalized();
         geom::Vector3 offset2 = 0.5f * thickness * geom::Vector3::cross(p2 - camera.translation, p2 - p1).normalized();
-
-        std::vector<VectorVertex> vertices;
-        vertices.reserve(6);
-        vertices.push_back({ p1 + offset1 });
-        vertices.push_back({ p1 - offset1 });
-        vertices.push_back({ p2 - offset2 });
-        vertices.push_back({ p1 + offset1 });
-        vertices.push_back({ p2 - offset2 });
-        vertices.push_back({ p2 + offset2 });
-
-        draw(camera.calculate_camera_matrix(), vertices, colour);
+        add_quad(p1 + offset1, p1 - offset1, p2 - offset2, p2 + offset2, colour);
     }
 
-    void DebugShader::draw(const geom::Matrix44& camera, const std::vector<VectorVertex>& vertices, Colour colour)
+    void DebugShader::add_quad(const geom::Vector3& p1, const geom::Vector3& p2, const geom::Vector3& p3, const geom::Vector3& p4, Colour colour)
     {
-        use();
-        set_uniform("camera", camera);
-        set_uniform("colour", colour);
-
-        VertexArray vao(VertexBuffer(vertices, GL_STREAM_DRAW), nullptr, 0);
-        vao.use();
-
-        glDrawArrays(GL_TRIANGLES, 0, (int)vertices.size());
+        _ASSERT(m_vertices.has_value());
+        m_vertices->push_back({ p1, colour });
+        m_vertices->push_back({ p2, colour });
+        m_vertices->push_back({ p3, colour });
+        m_vertices->push_back({ p1, colour });
+        m_vertices->push_back({ p3, colour });
+        m_vertices->push_back({ p4, colour });
     }
 
-}
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "glad/glad.h"
 
 #include <iostream>
+#include <span>
 #include <vector>
 
 namespace graphics
@@ -45,7 +46,7 @@ namespace graphics
 
         void set_uniform(const char* name, const Colour& colour) const;
         void set_uniform(const char* name, const geom::Matrix44& matrix) const;
-        void set_uniform(const char* name, const std::vector<geom::Matrix44>& matrices) const;
+        void set_uniform(const char* name, std::span<const geom::Matrix44> matrices) const;
 
         bool valid() const { return m_program_id != 0; }
         unsigned int id() const { return m_program_id; }
@@ -13,7 +13,7 @@ namespace graphics
     {
     public:
         ~VertexArray();
-        VertexArray(VertexBuffer<VertexType> vertices, unsigned int* indices, int indices_count);
+        VertexArray(VertexBuffer<VertexType> vertices, const unsigned int* indices, int indices_count);
         VertexArray(VertexArray&& other);
         VertexArray& operator=(VertexArray&& other);
 
@@ -37,7 +37,7 @@ namespace graphics
     }
 
     template<Vertex VertexType>
-    VertexArray<VertexType>::VertexArray(VertexBuffer<VertexType> vertices, unsigned int* indices, int indices_count)
+    VertexArray<VertexType>::VertexArray(VertexBuffer<VertexType> vertices, const unsigned int* indices, int indices_count)
         : m_num_indices(indices_count)
         , m_vbo(std::move(vertices))
     {
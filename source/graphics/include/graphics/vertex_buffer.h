@@ -2,6 +2,7 @@
 
 #include "glad/glad.h"
 
+#include <span>
 #include <vector>
 
 namespace graphics
@@ -17,6 +18,7 @@ namespace graphics
     public:
         ~VertexBuffer();
         VertexBuffer(const std::vector<VertexType>& vertices, unsigned int usage_type = GL_STATIC_DRAW);
+        VertexBuffer(std::span<const VertexType> vertices, unsigned int usage_type = GL_STATIC_DRAW);
         VertexBuffer(VertexBuffer&& other);
         VertexBuffer& operator=(VertexBuffer&& other);
 
@@ -39,6 +41,11 @@ namespace graphics
 
     template<Vertex VertexType>
     VertexBuffer<VertexType>::VertexBuffer(const std::vector<VertexType>& vertices, unsigned int usage_type)
+        : VertexBuffer(std::span<const VertexType>(vertices), usage_type)
+    {}
+
+    template<Vertex VertexType>
+    VertexBuffer<VertexType>::VertexBuffer(std::span<const VertexType> vertices, unsigned int usage_type)
     {
         glGenBuffers(1, &m_vbo);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
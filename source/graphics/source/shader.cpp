@@ -66,7 +66,7 @@ namespace graphics
         glUniformMatrix4fv(location, 1, GL_FALSE, matrix.values);
     }
 
-    void Program::set_uniform(const char* name, const std::vector<geom::Matrix44>& matrices) const
+    void Program::set_uniform(const char* name, std::span<const geom::Matrix44> matrices) const
     {
         unsigned int location = glGetUniformLocation(m_program_id, name);
         glUniformMatrix4fv(location, (int)matrices.size(), GL_FALSE, matrices[0].values);
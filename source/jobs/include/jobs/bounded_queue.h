@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace jobs
+{
+    //a fixed capacity queue that any number of threads push to and pop from without taking a lock
+    //each slot has a sequence number saying whether it is ready to be written or read on the current lap of the ring,
+    //so a push or pop claims its position with one compare and swap and then only touches the slot it claimed
+    //a value popped by one thread was written before its push returned on another, so it can hand over anything the pusher filled in
+    //the capacity is rounded up to a power of two, and pushing to a full queue fails rather than growing it
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue(int capacity);
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        int capacity() const { return (int)(m_mask + 1); }
+
+        //false if the queue is full
+        bool try_push(T value);
+        //false if the queue is empty
+        bool try_pop(T& out);
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        size_t m_mask = 0;
+        //pushers and poppers each get a cache line, so they don't slow each other down
+        alignas(64) std::atomic<size_t> m_tail = 0;
+        alignas(64) std::atomic<size_t> m_head = 0;
+    };
+}
+
+//inline definitions
+namespace jobs
+{
+    template<typename T>
+    BoundedQueue<T>::BoundedQueue(int capacity)
+        : m_slots(std::make_unique<Slot[]>(std::bit_ceil((size_t)std::max(capacity, 2))))
+        , m_mask(std::bit_ceil((size_t)std::max(capacity, 2)) - 1)
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    bool BoundedQueue<T>::try_push(T value)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0)
+            {
+                //the slot is free on this lap, claim it unless another pusher got there first
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                //the slot still holds a value from the lap before, so the queue is full
+                return false;
+            }
+            else
+            {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<typename T>
+    bool BoundedQueue<T>::try_pop(T& out)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (difference == 0)
+            {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    out = std::move(slot.value);
+                    //free for the push a lap later
+                    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                //nothing has been pushed to the slot yet, so the queue is empty
+                return false;
+            }
+            else
+            {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+}
\ No newline at end of file
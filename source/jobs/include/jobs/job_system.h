@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace jobs
+{
+    //a pool of worker threads that share out ranges of work by stealing from each other
+    //each thread has its own deque of tasks, it pushes and pops at the back while idle threads steal from the front,
+    //so a thread works through its own tasks in cache friendly order and large ranges are only split when another thread is idle
+    //a thread waiting for its work to finish runs tasks too, so jobs can start more jobs without deadlocking
+    class JobSystem
+    {
+    public:
+        //thread_count includes the thread that calls parallel_for, 0 uses one per hardware thread
+        explicit JobSystem(int thread_count = 0);
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        int thread_count() const { return (int)m_queues.size(); }
+
+        //calls body(begin, end) on sub-ranges of [begin, end) of at most grain_size, and returns once all have finished
+        //a thread halves the range it takes until it is small enough, leaving the halves for itself or other threads to take
+        template<typename Body>
+        void parallel_for(int begin, int end, int grain_size, Body&& body);
+
+    private:
+        struct Task
+        {
+            void (*run)(const void* body, int begin, int end) = nullptr;
+            const void* body = nullptr;
+            int begin = 0;
+            int end = 0;
+            int grain_size = 1;
+            std::atomic<int>* remaining = nullptr;
+        };
+
+        //fixed capacity ring buffer, a parallel_for only needs a slot for each time its range is halved
+        //if it fills up the range being split is run without splitting any further
+        struct alignas(64) TaskQueue
+        {
+            static constexpr int capacity = 256;
+
+            std::mutex mutex;
+            Task tasks[capacity];
+            int front = 0;
+            int count = 0;
+        };
+
+        bool push(int queue, const Task&);
+        bool pop(int queue, Task&);
+        bool steal(int thief, Task&);
+        //runs a task from this thread's queue or another's, false if there was none
+        bool run_one(int queue);
+        void execute(int queue, Task task);
+        void worker_loop(int queue);
+        int current_queue() const;
+        void run_and_wait(const Task&);
+
+        std::vector<std::unique_ptr<TaskQueue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::atomic<int> m_queued = 0;
+        std::atomic<int> m_sleeping = 0;
+        std::atomic<bool> m_stopping = false;
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+    };
+}
+
+//inline definitions
+namespace jobs
+{
+    template<typename Body>
+    void JobSystem::parallel_for(int begin, int end, int grain_size, Body&& body)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+
+        using BodyType = std::remove_reference_t<Body>;
+        Task task;
+        task.run = [](const void* body, int begin, int end) { (*static_cast<BodyType*>(const_cast<void*>(body)))(begin, end); };
+        task.body = &body;
+        task.begin = begin;
+        task.end = end;
+        task.grain_size = grain_size < 1 ? 1 : grain_size;
+        run_and_wait(task);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+namespace jobs
+{
+    namespace
+    {
+        //the job system and queue of the calling thread, threads outside any job system share queue 0
+        thread_local const JobSystem* s_job_system = nullptr;
+        thread_local int s_queue = 0;
+
+        //attempts to find work before a worker goes to sleep
+        constexpr int g_spin_count = 64;
+    }
+
+    JobSystem::JobSystem(int thread_count)
+    {
+        if (thread_count <= 0)
+        {
+            thread_count = std::max((int)std::thread::hardware_concurrency(), 1);
+        }
+
+        for (int i = 0; i < thread_count; ++i)
+        {
+            m_queues.push_back(std::make_unique<TaskQueue>());
+        }
+        //the thread calling parallel_for makes up the count
+        for (int i = 1; i < thread_count; ++i)
+        {
+            m_threads.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        m_stopping = true;
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    bool JobSystem::push(int queue, const Task& task)
+    {
+        {
+            TaskQueue& tasks = *m_queues[queue];
+            std::lock_guard<std::mutex> lock(tasks.mutex);
+            if (tasks.count == TaskQueue::capacity)
+            {
+                return false;
+            }
+            tasks.tasks[(tasks.front + tasks.count) % TaskQueue::capacity] = task;
+            ++tasks.count;
+        }
+
+        //a sleeping worker registers itself before checking for work under the sleep mutex,
+        //so either it sees this task or it is counted here and waiting by the time the mutex is taken
+        ++m_queued;
+        if (m_sleeping > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            }
+            m_wake.notify_one();
+        }
+        return true;
+    }
+
+    bool JobSystem::pop(int queue, Task& task)
+    {
+        TaskQueue& tasks = *m_queues[queue];
+        std::lock_guard<std::mutex> lock(tasks.mutex);
+        if (tasks.count == 0)
+        {
+            return false;
+        }
+        --tasks.count;
+        task = tasks.tasks[(tasks.front + tasks.count) % TaskQueue::capacity];
+        --m_queued;
+        return true;
+    }
+
+    bool JobSystem::steal(int thief, Task& task)
+    {
+        int queue_count = thread_count();
+        for (int i = 1; i < queue_count; ++i)
+        {
+            TaskQueue& tasks = *m_queues[(thief + i) % queue_count];
+            std::lock_guard<std::mutex> lock(tasks.mutex);
+            if (tasks.count > 0)
+            {
+                task = tasks.tasks[tasks.front];
+                tasks.front = (tasks.front + 1) % TaskQueue::capacity;
+                --tasks.count;
+                --m_queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::run_one(int queue)
+    {
+        Task task;
+        if (pop(queue, task) || steal(queue, task))
+        {
+            execute(queue, task);
+            return true;
+        }
+        return false;
+    }
+
+    void JobSystem::execute(int queue, Task task)
+    {
+        //keep the first half and leave the second, which is the largest range in the queue's back, to be taken next or stolen
+        while (task.end - task.begin > task.grain_size)
+        {
+            Task second_half = task;
+            second_half.begin = task.begin + (task.end - task.begin) / 2;
+            if (!push(queue, second_half))
+            {
+                break;
+            }
+            task.end = second_half.begin;
+        }
+
+        task.run(task.body, task.begin, task.end);
+        task.remaining->fetch_sub(task.end - task.begin);
+    }
+
+    void JobSystem::worker_loop(int queue)
+    {
+        s_job_system = this;
+        s_queue = queue;
+        while (!m_stopping)
+        {
+            bool found = false;
+            for (int i = 0; i < g_spin_count && !found; ++i)
+            {
+                found = run_one(queue);
+            }
+            if (found)
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            ++m_sleeping;
+            m_wake.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+            --m_sleeping;
+        }
+    }
+
+    int JobSystem::current_queue() const
+    {
+        return s_job_system == this ? s_queue : 0;
+    }
+
+    void JobSystem::run_and_wait(const Task& task)
+    {
+        std::atomic<int> remaining = task.end - task.begin;
+        Task root = task;
+        root.remaining = &remaining;
+
+        //help with any work while waiting, including other callers' tasks, as a blocked thread would waste a core
+        int queue = current_queue();
+        execute(queue, root);
+        while (remaining > 0)
+        {
+            if (!run_one(queue))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "asset_manager.h"
+
+#include "fbx_wrapper.h"
+#include "native_content.h"
+
+#include "file/file_scanner.h"
+
+AssetManager::AssetManager(const std::filesystem::path& directory, int loader_count)
+    : m_assets(find_assets(directory))
+    , m_requested(asset_count())
+    , m_loaded(asset_count())
+    , m_import_cache(open_import_cache(fbx_import_settings_hash()))
+{
+    for (int i = 0; i < loader_count; ++i)
+    {
+        m_loaders.emplace_back([this]() { loader_loop(); });
+    }
+}
+
+AssetManager::~AssetManager()
+{
+    m_stopping = true;
+    m_pending.release((ptrdiff_t)m_loaders.size());
+    for (auto& loader : m_loaders)
+    {
+        loader.join();
+    }
+    m_import_cache.save();
+}
+
+const LoadedAsset* AssetManager::request(int asset)
+{
+    if (asset < 0 || asset >= asset_count())
+    {
+        return nullptr;
+    }
+
+    Asset& requested = m_assets[asset];
+    if (requested.state == State::Unloaded)
+    {
+        requested.state = State::Loading;
+        bool pushed = m_requested.try_push(asset);
+        _ASSERT(pushed);
+        m_pending.release();
+    }
+    return requested.ready.get();
+}
+
+int AssetManager::upload_loaded()
+{
+    int count = 0;
+    int index;
+    while (m_loaded.try_pop(index))
+    {
+        ++count;
+        Asset& asset = m_assets[index];
+        FbxFileContent& content = asset.loaded_content;
+        if (!content.skeleton || !asset.loaded_bone_lods)
+        {
+            asset.state = State::Failed;
+            continue;
+        }
+
+        auto vao = graphics::VertexArray<SkinnedVertex>(
+            graphics::VertexBuffer(content.mesh_vertices()),
+            content.mesh_indices().data(),
+            (int)content.mesh_indices().size());
+        asset.ready = std::make_unique<LoadedAsset>(LoadedAsset{ std::move(content), std::move(vao), std::move(*asset.loaded_bone_lods) });
+        asset.loaded_bone_lods.reset();
+        asset.state = State::Ready;
+    }
+    return count;
+}
+
+std::vector<AssetManager::Asset> AssetManager::find_assets(const std::filesystem::path& directory)
+{
+    std::vector<Asset> assets;
+    for (auto& path : file::fbx_paths(directory))
+    {
+        assets.push_back({ path });
+    }
+    return assets;
+}
+
+void AssetManager::loader_loop()
+{
+    //the fbx sdk is only started on a loader that has a file to import
+    std::optional<FBXManagerWrapper> fbx_manager;
+    while (true)
+    {
+        m_pending.acquire();
+        int asset;
+        if (m_stopping || !m_requested.try_pop(asset))
+        {
+            return;
+        }
+
+        load(m_assets[asset], fbx_manager);
+        bool pushed = m_loaded.try_push(asset);
+        _ASSERT(pushed);
+    }
+}
+
+void AssetManager::load(Asset& asset, std::optional<FBXManagerWrapper>& fbx_manager)
+{
+    FbxFileContent& content = asset.loaded_content;
+    std::filesystem::path cached_path;
+    {
+        std::lock_guard<std::mutex> lock(m_import_cache_mutex);
+        cached_path = m_import_cache.find(asset.path);
+    }
+
+    if (cached_path.empty() || !read_native_content(cached_path, content))
+    {
+        if (!fbx_manager)
+        {
+            fbx_manager.emplace();
+        }
+        content = fbx_manager->load_file_content(asset.path.string().c_str());
+        if (!content.skeleton)
+        {
+            return;
+        }
+
+        //written under the lock too, as sources with the same content share a converted file
+        //a failed write isn't cached, so the file is imported again next time
+        std::lock_guard<std::mutex> lock(m_import_cache_mutex);
+        m_import_cache.add(asset.path, content.dependencies, [&](const std::filesystem::path& path) { return write_native_content(content, path); });
+    }
+
+    if (content.skeleton)
+    {
+        asset.loaded_bone_lods.emplace(*content.skeleton);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "file_content.h"
+
+#include "animation/lod.h"
+
+#include "graphics/vertex_array.h"
+
+#include "file/filepaths.h"
+#include "file/import_cache.h"
+
+#include "jobs/bounded_queue.h"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+class FBXManagerWrapper;
+
+//a character's content once it's loaded and its mesh is on the gpu
+struct LoadedAsset
+{
+    FbxFileContent file_content;
+    graphics::VertexArray<SkinnedVertex> vao;
+    anim::BoneLods bone_lods;
+};
+
+//finds the fbx files at startup and loads each one the first time it's asked for, so the window opens without waiting for any of them
+//files are read from the import cache, or imported and cached, on loader threads of the manager's own,
+//then handed to the main thread through a lock free queue to upload their mesh, as only the thread with the gl context can
+//a file's mesh and clips are in one file, so asking for either loads both
+//everything but the constructor and destructor is called from the main thread
+class AssetManager
+{
+public:
+    enum class State
+    {
+        Unloaded,
+        Loading,
+        Ready,
+        Failed,
+    };
+
+    explicit AssetManager(const std::filesystem::path& directory = file::g_fbx_path, int loader_count = 2);
+    //waits for files being loaded to finish, files waiting to start are dropped
+    ~AssetManager();
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    int asset_count() const { return (int)m_assets.size(); }
+    const std::filesystem::path& path(int asset) const { return m_assets[asset].path; }
+    State state(int asset) const { return m_assets[asset].state; }
+
+    //the asset if it's ready, otherwise null, and the first time an asset is asked for it starts loading
+    //out of range assets are null and never load
+    const LoadedAsset* request(int asset);
+    //uploads the meshes of assets the loaders have finished and makes them ready, returns how many there were
+    int upload_loaded();
+
+private:
+    struct Asset
+    {
+        std::filesystem::path path;
+        State state = State::Unloaded;
+        //filled in by the loader, then only touched by the main thread once the asset is popped from m_loaded
+        FbxFileContent loaded_content;
+        std::optional<anim::BoneLods> loaded_bone_lods;
+        std::unique_ptr<LoadedAsset> ready;
+    };
+
+    static std::vector<Asset> find_assets(const std::filesystem::path& directory);
+    void loader_loop();
+    //leaves the content without a skeleton if the file couldn't be loaded
+    void load(Asset& asset, std::optional<FBXManagerWrapper>& fbx_manager);
+
+    std::vector<Asset> m_assets;
+    //each asset is pushed at most once to each queue, so they have room for all of them and pushing never fails
+    jobs::BoundedQueue<int> m_requested;
+    jobs::BoundedQueue<int> m_loaded;
+    //counts the requests waiting in m_requested, so idle loaders sleep
+    std::counting_semaphore<> m_pending{ 0 };
+    std::atomic<bool> m_stopping = false;
+
+    //finding and adding files updates the cache's manifest, which loaders share
+    std::mutex m_import_cache_mutex;
+    file::ImportCache m_import_cache;
+
+    std::vector<std::thread> m_loaders;
+};
\ No newline at end of file
@@ -1,14 +1,37 @@
 #include "fbx_wrapper.h"
 #include "maths/geometry.h"
 
+#include "file/hash.h"
+
+#include "jobs/job_system.h"
+
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    //settings that change what the importer produces, fbx_import_settings_hash covers them so changing one invalidates cached imports
+    //fbx files are in centimetres and the app works in metres
+    constexpr float g_unit_scale = 0.01f;
+    //anim stacks are baked to a keyframe per frame at this rate
+    constexpr float g_bake_frame_rate = 30.f;
+    constexpr anim::BoneOrder g_bone_order = anim::BoneOrder::BreadthFirst;
+
+    FbxManager* create_manager()
+    {
+        FbxManager* manager = FbxManager::Create();
+        FbxIOSettings* ioSettings = FbxIOSettings::Create(manager, "");
+        manager->SetIOSettings(ioSettings);
+        return manager;
+    }
+}
 
 //housekeeping
 FBXManagerWrapper::FBXManagerWrapper()
 {
-    m_manager = FbxManager::Create();
-    FbxIOSettings* ioSettings = FbxIOSettings::Create(m_manager, "");
-    m_manager->SetIOSettings(ioSettings);
+    m_manager = create_manager();
 }
 
 FBXManagerWrapper::~FBXManagerWrapper()
@@ -26,7 +49,7 @@ namespace
 {
     //scene loading and unloading
 
-    FbxScene* load(FbxManager& manager, const char* filename)
+    FbxScene* load(FbxManager& manager, const char* filename, bool triangulate = true)
     {
         FbxImporter* importer = FbxImporter::Create(&manager, "");
 
@@ -43,8 +66,11 @@ namespace
         importer->Destroy();
 
         //only want to draw triangles and not quads, so convert the scene immediately
-        FbxGeometryConverter converter(&manager);
-        converter.Triangulate(scene, true);
+        if (triangulate)
+        {
+            FbxGeometryConverter converter(&manager);
+            converter.Triangulate(scene, true);
+        }
 
         return scene;
     }
@@ -67,16 +93,18 @@ namespace
         FbxSkin* skin = nullptr;
 
         std::vector<FbxNode*> skeleton_nodes;
+        //new index of each cluster's bone after the bones are sorted
+        std::vector<int> bone_order;
     };
 
     //conversions
 
-    geom::Quaternion right_to_left_hand(geom::Quaternion q)
+    constexpr geom::Quaternion right_to_left_hand(geom::Quaternion q)
     {
         return { -q.x, -q.y, q.z, q.w };
     }
 
-    geom::Vector3 right_to_left_hand(geom::Vector3 v)
+    constexpr geom::Vector3 right_to_left_hand(geom::Vector3 v)
     {
         return { v.x, v.y, -v.z };
     }
@@ -159,10 +187,9 @@ namespace
     {
         anim::Skeleton& skeleton = *context.result.skeleton;
 
-        //resize the bone and inverse matrix stack arrays to the cluster count
+        //resize the bone array to the cluster count, the bind pose matrices are derived from the bones by update_hierarchy
         int cluster_count = context.skin->GetClusterCount();
         skeleton.bones.resize(cluster_count);
-        skeleton.inv_matrix_stack.resize(cluster_count);
 
         //iterate over clusters and get their global transforms and hierarchy
         for (int cluster_index = 0; cluster_index < cluster_count; ++cluster_index)
@@ -171,11 +198,8 @@ namespace
             FbxNode* linked_node = cluster->GetLink();
             context.skeleton_nodes.push_back(linked_node);
 
-            //debug
-            std::cout << linked_node->GetName() << "\n";
-            //debug
-
             anim::Skeleton::Bone bone;
+            bone.name = linked_node->GetName();
             auto& global_transform = linked_node->EvaluateGlobalTransform();
             auto global_translation = global_transform.GetT();
             auto global_rotation = global_transform.GetR();
@@ -183,7 +207,7 @@ namespace
             bone.global_transform.translation.x = (float)global_translation[0];
             bone.global_transform.translation.y = (float)global_translation[1];
             bone.global_transform.translation.z = (float)global_translation[2];
-            bone.global_transform.translation = right_to_left_hand(bone.global_transform.translation) * 0.01f;
+            bone.global_transform.translation = right_to_left_hand(bone.global_transform.translation) * g_unit_scale;
 
             float deg_to_rad = geom::PI / 180.f;
             float xrot = deg_to_rad * (float)global_rotation[0];
@@ -191,12 +215,6 @@ namespace
             float zrot = deg_to_rad * (float)global_rotation[2];
             bone.global_transform.rotation = right_to_left_hand(get_quaternion_from_fbx_euler(xrot, yrot, zrot, FbxEuler::EOrder::eOrderXYZ));
 
-            //global_transform
-            skeleton.inv_matrix_stack[cluster_index] = (
-                geom::create_translation_matrix_44(bone.global_transform.translation) *
-                geom::create_rotation_matrix_from_quaternion(bone.global_transform.rotation))
-                .inverse();
-
             bone.parent_index = -1;
             for (int i = 0; i < context.skeleton_nodes.size(); ++i)
             {
@@ -212,6 +230,20 @@ namespace
 
             skeleton.bones[cluster_index] = bone;
         }
+
+        //sort the bones breadth first so the hierarchy can be walked a depth level at a time
+        //the nodes are kept in bone order as the animations are read through them, and the vertices' skin indices follow their bones
+        context.bone_order = anim::reorder_bones(skeleton, g_bone_order);
+        std::vector<FbxNode*> sorted_nodes(context.skeleton_nodes.size());
+        for (int i = 0; i < context.skeleton_nodes.size(); ++i)
+        {
+            sorted_nodes[context.bone_order[i]] = context.skeleton_nodes[i];
+        }
+        context.skeleton_nodes = std::move(sorted_nodes);
+        for (auto& vertex : context.result.vertices)
+        {
+            vertex.skinned_bone_index = context.bone_order[vertex.skinned_bone_index];
+        }
     }
 
     //anim + keyframe processing
@@ -275,13 +307,48 @@ namespace
             transform.rotation = get_quaternion_from_fbx_euler(xrot, yrot, zrot, FbxEuler::EOrder::eOrderXYZ);
 
             //convert coordinate systems
-            transform.translation = right_to_left_hand(transform.translation) * 0.01f;
+            transform.translation = right_to_left_hand(transform.translation) * g_unit_scale;
             transform.rotation = right_to_left_hand(transform.rotation.normalized());
         }
 
         return pose;
     }
 
+    //time of each keyframe baked from the anim stack
+    std::vector<float> bake_times(FbxAnimStack& anim_stack)
+    {
+        float duration = 0.001f * (float)anim_stack.GetLocalTimeSpan().GetDuration().GetMilliSeconds();
+
+        //a keyframe every frame, the final one trimmed to the duration
+        constexpr float frame_dt = 1.f / g_bake_frame_rate;
+        std::vector<float> times;
+        times.reserve((int)(duration / frame_dt) + 2);
+        for (int frame = 0;; ++frame)
+        {
+            float time = frame_dt * frame;
+            if (time > duration)
+            {
+                times.push_back(duration);
+                return times;
+            }
+            times.push_back(time);
+        }
+    }
+
+    FbxAnimLayer* select_anim_stack(FbxScene& scene, FbxAnimStack& anim_stack)
+    {
+        _ASSERT(anim_stack.GetSrcObjectCount<FbxAnimLayer>() == 1);
+        scene.SetCurrentAnimationStack(&anim_stack);
+        return anim_stack.GetSrcObject<FbxAnimLayer>(0);
+    }
+
+    anim::Pose bake_keyframe(float time, const anim::Skeleton& skeleton, const std::vector<FbxNode*>& skeleton_nodes, FbxAnimLayer* anim_layer)
+    {
+        FbxTime ftime;
+        ftime.SetMilliSeconds((FbxLongLong)(time * 1000.f));
+        return process_keyframe(ftime, skeleton, skeleton_nodes, anim_layer);
+    }
+
     void process_animations(LoadContext& context)
     {
         auto& animations = context.result.animations;
@@ -294,54 +361,31 @@ namespace
             FbxAnimStack* anim_stack = scene.GetSrcObject<FbxAnimStack>(i);
             std::cout << "Loading anim stack: " << anim_stack->GetName() << "\n";
 
-            float duration = 0.001f * (float)anim_stack->GetLocalTimeSpan().GetDuration().GetMilliSeconds();
-            _ASSERT(anim_stack->GetSrcObjectCount<FbxAnimLayer>() == 1);
-            FbxAnimLayer* anim_layer = anim_stack->GetSrcObject<FbxAnimLayer>(0);
-
+            FbxAnimLayer* anim_layer = select_anim_stack(scene, *anim_stack);
             animations.push_back({ anim_stack->GetName(), anim::Animation(skeleton) });
             anim::Animation& animation = animations.back().animation;
 
-            scene.SetCurrentAnimationStack(anim_stack);
-
-            //loop over frames and create a keyframe for each one
-            constexpr float frame_dt = 1.f / 30.f;
-            for (int frame = 0;; ++frame)
+            //create a keyframe for each frame
+            std::vector<float> times = bake_times(*anim_stack);
+            animation.reserve((int)times.size(), (int)context.skeleton_nodes.size());
+            for (float time : times)
             {
-                float time = frame_dt * frame;
-                
-                //if this is the final frame, trim the time and set a flag so we remember to exit
-                bool final_frame = false;
-                if (time > duration)
-                {
-                    time = duration;
-                    final_frame = true;
-                }
-
-                //create the keyframe
-                FbxTime ftime;
-                ftime.SetMilliSeconds((FbxLongLong)(time * 1000.f));
-                animation.add_keyframe(
-                    process_keyframe(ftime, skeleton, context.skeleton_nodes, anim_layer),
-                    time);
-
-                if (final_frame)
-                {
-                    break;
-                }
+                animation.add_keyframe(bake_keyframe(time, skeleton, context.skeleton_nodes, anim_layer), time);
             }
         }
     }
 
     //main funcs
 
-    void read_file_content(LoadContext& context)
+    //finds the mesh and its skin, false if the scene has no mesh
+    bool find_mesh(LoadContext& context)
     {
         //get root node
         context.root_node = context.scene.GetRootNode();
         if (context.root_node == nullptr)
         {
             //error
-            return;
+            return false;
         }
         FbxNode& root_node = *context.root_node;
 
@@ -361,7 +405,7 @@ namespace
         if (context.mesh == nullptr)
         {
             //error
-            return;
+            return false;
         }
         FbxMesh& mesh = *context.mesh;
 
@@ -370,6 +414,35 @@ namespace
         {
             context.skin = static_cast<FbxSkin*>(mesh.GetDeformer(0, FbxDeformer::EDeformerType::eSkin));
         }
+        return true;
+    }
+
+    //texture files the scene references that exist, the mesh doesn't use them yet
+    //but recording them means a cached import is redone when they change once it does
+    void find_dependencies(LoadContext& context)
+    {
+        int texture_count = context.scene.GetSrcObjectCount<FbxFileTexture>();
+        for (int i = 0; i < texture_count; ++i)
+        {
+            std::filesystem::path path = context.scene.GetSrcObject<FbxFileTexture>(i)->GetFileName();
+            std::error_code error;
+            if (!path.empty() && std::filesystem::is_regular_file(path, error)
+                && std::find(context.result.dependencies.begin(), context.result.dependencies.end(), path) == context.result.dependencies.end())
+            {
+                context.result.dependencies.push_back(path);
+            }
+        }
+    }
+
+    //everything but the animations
+    void read_mesh_and_skeleton(LoadContext& context)
+    {
+        find_dependencies(context);
+        if (!find_mesh(context))
+        {
+            return;
+        }
+        FbxMesh& mesh = *context.mesh;
 
         //get vertices
         FbxVector4* mesh_control_points = mesh.GetControlPoints();
@@ -385,9 +458,9 @@ namespace
             auto point = mesh_transform.MultT(mesh_control_points[control_point_index]);
             vertices.push_back({ 
                 right_to_left_hand(geom::Vector3{
-                    0.01f * (float)point.mData[0],
-                    0.01f * (float)point.mData[1],
-                    0.01f * (float)point.mData[2]}),
+                    g_unit_scale * (float)point.mData[0],
+                    g_unit_scale * (float)point.mData[1],
+                    g_unit_scale * (float)point.mData[2]}),
                 skinned_index
                 });
 
@@ -409,11 +482,293 @@ namespace
 
         context.result.skeleton = std::make_unique<anim::Skeleton>();
         process_skeleton_nodes(context);
+    }
+
+    void read_file_content(LoadContext& context)
+    {
+        read_mesh_and_skeleton(context);
+        if (context.result.skeleton)
+        {
+            process_animations(context);
+        }
+    }
+
+    //parallel loading
+
+    //a scene loaded by its own manager, so it can be used on one thread while other threads use other copies
+    struct LoadedScene
+    {
+        FbxManager* manager = nullptr;
+        FbxScene* scene = nullptr;
+        //the skin's nodes in bone order
+        std::vector<FbxNode*> skeleton_nodes;
+    };
+
+    //copies of one file's scene, a task takes a copy that no other task is using or loads another
+    //so there are only ever as many copies as tasks that have run at once
+    class ScenePool
+    {
+    public:
+        ScenePool(const std::filesystem::path& path) : m_path(path.string()) {}
+        ~ScenePool()
+        {
+            for (LoadedScene& loaded : m_free)
+            {
+                unload(*loaded.scene);
+                loaded.manager->Destroy();
+            }
+        }
+
+        //the first copy is triangulated for reading the mesh, the rest are only used for baking animations
+        LoadedScene acquire(bool triangulate = false)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_free.empty())
+                {
+                    LoadedScene loaded = std::move(m_free.back());
+                    m_free.pop_back();
+                    return loaded;
+                }
+            }
+
+            LoadedScene loaded;
+            loaded.manager = create_manager();
+            loaded.scene = load(*loaded.manager, m_path.c_str(), triangulate);
+            if (loaded.scene == nullptr)
+            {
+                loaded.manager->Destroy();
+                loaded.manager = nullptr;
+            }
+            return loaded;
+        }
+
+        void release(LoadedScene loaded)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(std::move(loaded));
+        }
 
-        //get animations
-        process_animations(context);
+    private:
+        std::string m_path;
+        std::mutex m_mutex;
+        std::vector<LoadedScene> m_free;
+    };
+
+    //a run of frames of one anim stack, baked by one task
+    struct BakeChunk
+    {
+        int stack = 0;
+        int first_frame = 0;
+        int frame_count = 0;
+        std::vector<anim::Pose> poses;
+        bool baked = false;
+    };
+
+    //long enough that baking outweighs taking a scene copy, short enough that a long clip is shared between threads
+    constexpr int g_frames_per_bake_chunk = 60;
+
+    //one file's part of a parallel load, its chunks are baked in the same range as every other file's
+    struct FileBake
+    {
+        std::unique_ptr<ScenePool> pool;
+        const anim::Skeleton* skeleton = nullptr;
+        //new index of each cluster's bone, as worked out for the first copy
+        std::vector<int> bone_order;
+        std::vector<std::string> stack_names;
+        std::vector<std::vector<float>> stack_times;
+        std::vector<BakeChunk> chunks;
+    };
+
+    //reads the mesh and skeleton from the first copy and splits every anim stack into chunks of frames
+    void prepare_bake(const std::filesystem::path& path, FbxFileContent& result, FileBake& bake)
+    {
+        bake.pool = std::make_unique<ScenePool>(path);
+        LoadedScene first = bake.pool->acquire(true);
+        if (first.scene == nullptr)
+        {
+            //invalid file
+            return;
+        }
+
+        LoadContext context = { *first.scene, result };
+        read_mesh_and_skeleton(context);
+        if (!result.skeleton)
+        {
+            bake.pool->release(std::move(first));
+            return;
+        }
+        first.skeleton_nodes = context.skeleton_nodes;
+        bake.skeleton = result.skeleton.get();
+        bake.bone_order = std::move(context.bone_order);
+
+        int stack_count = first.scene->GetSrcObjectCount<FbxAnimStack>();
+        bake.stack_names.resize(stack_count);
+        bake.stack_times.resize(stack_count);
+        for (int stack = 0; stack < stack_count; ++stack)
+        {
+            FbxAnimStack* anim_stack = first.scene->GetSrcObject<FbxAnimStack>(stack);
+            bake.stack_names[stack] = anim_stack->GetName();
+            bake.stack_times[stack] = bake_times(*anim_stack);
+            int frame_count = (int)bake.stack_times[stack].size();
+            for (int frame = 0; frame < frame_count; frame += g_frames_per_bake_chunk)
+            {
+                bake.chunks.push_back({ stack, frame, std::min(g_frames_per_bake_chunk, frame_count - frame) });
+            }
+        }
+        bake.pool->release(std::move(first));
+    }
+
+    //the copies have the same clusters as the first scene, so the bone order worked out for it applies to them too
+    std::vector<FbxNode*> copy_skeleton_nodes(FbxScene& scene, const std::vector<int>& bone_order)
+    {
+        FbxFileContent unused;
+        LoadContext copy_context = { scene, unused };
+        std::vector<FbxNode*> nodes(bone_order.size());
+        if (find_mesh(copy_context) && copy_context.skin != nullptr)
+        {
+            for (int cluster = 0; cluster < (int)nodes.size(); ++cluster)
+            {
+                nodes[bone_order[cluster]] = copy_context.skin->GetCluster(cluster)->GetLink();
+            }
+        }
+        return nodes;
+    }
+
+    void bake_chunk(const FileBake& bake, LoadedScene& loaded, BakeChunk& chunk)
+    {
+        if (loaded.skeleton_nodes.empty())
+        {
+            loaded.skeleton_nodes = copy_skeleton_nodes(*loaded.scene, bake.bone_order);
+        }
+        FbxAnimLayer* anim_layer = select_anim_stack(*loaded.scene, *loaded.scene->GetSrcObject<FbxAnimStack>(chunk.stack));
+        const std::vector<float>& times = bake.stack_times[chunk.stack];
+        chunk.poses.reserve(chunk.frame_count);
+        for (int frame = chunk.first_frame; frame < chunk.first_frame + chunk.frame_count; ++frame)
+        {
+            chunk.poses.push_back(bake_keyframe(times[frame], *bake.skeleton, loaded.skeleton_nodes, anim_layer));
+        }
+        chunk.baked = true;
     }
 
+    //bakes the chunks a task couldn't load a copy for and adds the keyframes, then frees the file's copies
+    void finish_bake(const std::filesystem::path& path, FileBake& bake, FbxFileContent& result)
+    {
+        if (bake.skeleton == nullptr)
+        {
+            bake.pool.reset();
+            return;
+        }
+
+        //every copy is back in the pool now, so a task that couldn't load another copy has its chunks baked on one of them
+        if (std::any_of(bake.chunks.begin(), bake.chunks.end(), [](const BakeChunk& chunk) { return !chunk.baked; }))
+        {
+            LoadedScene loaded = bake.pool->acquire();
+            if (loaded.scene == nullptr)
+            {
+                //fail the whole file rather than return clips with frames missing
+                std::cout << "Failed to bake the anim stacks of " << path << "\n";
+                result = {};
+                bake.pool.reset();
+                return;
+            }
+            for (BakeChunk& chunk : bake.chunks)
+            {
+                if (!chunk.baked)
+                {
+                    bake_chunk(bake, loaded, chunk);
+                }
+            }
+            bake.pool->release(std::move(loaded));
+        }
+        bake.pool.reset();
+
+        //chunks are in stack then frame order, so the keyframes are added exactly as a serial load adds them
+        const anim::Skeleton& skeleton = *bake.skeleton;
+        for (int stack = 0; stack < (int)bake.stack_names.size(); ++stack)
+        {
+            result.animations.push_back({ std::move(bake.stack_names[stack]), anim::Animation(skeleton) });
+            result.animations.back().animation.reserve((int)bake.stack_times[stack].size(), (int)skeleton.bones.size());
+        }
+        for (BakeChunk& chunk : bake.chunks)
+        {
+            anim::Animation& animation = result.animations[chunk.stack].animation;
+            for (int frame = 0; frame < (int)chunk.poses.size(); ++frame)
+            {
+                animation.add_keyframe(chunk.poses[frame], bake.stack_times[chunk.stack][chunk.first_frame + frame]);
+            }
+        }
+        bake.chunks = {};
+    }
+
+}
+
+uint64_t fbx_import_settings_hash()
+{
+    uint64_t hash = file::hash_combine(0, g_fbx_importer_version);
+    hash = file::hash_value(g_unit_scale, hash);
+    hash = file::hash_value(g_bake_frame_rate, hash);
+    return file::hash_value(g_bone_order, hash);
+}
+
+std::vector<FbxFileContent> load_file_contents(std::span<const std::filesystem::path> paths, jobs::JobSystem& job_system)
+{
+    std::vector<FbxFileContent> results(paths.size());
+    std::vector<FileBake> bakes(paths.size());
+    job_system.parallel_for(0, (int)paths.size(), 1, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                prepare_bake(paths[i], results[i], bakes[i]);
+            }
+        });
+
+    //every file's chunks go in one range, so there's a single parallel_for over the baking rather than one per file inside one over the files
+    std::vector<std::pair<int, int>> file_chunks;
+    for (int file = 0; file < (int)bakes.size(); ++file)
+    {
+        for (int chunk = 0; chunk < (int)bakes[file].chunks.size(); ++chunk)
+        {
+            file_chunks.push_back({ file, chunk });
+        }
+    }
+    job_system.parallel_for(0, (int)file_chunks.size(), 1, [&](int begin, int end)
+        {
+            //a task's range can cross files, it keeps a copy until it reaches a chunk of another file
+            int file = -1;
+            LoadedScene loaded;
+            for (int i = begin; i < end; ++i)
+            {
+                if (file_chunks[i].first != file)
+                {
+                    if (loaded.scene != nullptr)
+                    {
+                        bakes[file].pool->release(std::move(loaded));
+                    }
+                    file = file_chunks[i].first;
+                    loaded = bakes[file].pool->acquire();
+                }
+                if (loaded.scene == nullptr)
+                {
+                    //baked in finish_bake on a copy that's already loaded
+                    continue;
+                }
+                bake_chunk(bakes[file], loaded, bakes[file].chunks[file_chunks[i].second]);
+            }
+            if (loaded.scene != nullptr)
+            {
+                bakes[file].pool->release(std::move(loaded));
+            }
+        });
+
+    job_system.parallel_for(0, (int)paths.size(), 1, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                finish_bake(paths[i], bakes[i], results[i]);
+            }
+        });
+    return results;
 }
 
 FbxFileContent FBXManagerWrapper::load_file_content(const char* filename)
@@ -436,4 +791,4 @@ FbxFileContent FBXManagerWrapper::load_file_content(const char* filename)
     unload(*scene);
 
     return result;
-}
+}
\ No newline at end of file
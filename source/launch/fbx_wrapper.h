@@ -1,39 +1,24 @@
 #pragma once
 
-#include "animation/animation.h"
+#include "file_content.h"
 
 #include <fbxsdk.h>
-#include <glad/glad.h>
 
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <span>
+#include <vector>
 
-struct SkinnedVertex
+namespace jobs
 {
-    geom::Vector3 pos;
-    int skinned_bone_index;
-
-    static void apply_attributes()
-    {
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribIPointer(1, 1, GL_INT, sizeof(SkinnedVertex), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-    }
-};
+    class JobSystem;
+}
 
-struct FbxFileContent
-{
-    struct NamedAnim
-    {
-        std::string name;
-        anim::Animation animation;
-    };
-    std::vector<SkinnedVertex> vertices;
-    std::vector<unsigned int> indices;
-
-    std::unique_ptr<anim::Skeleton> skeleton;
-    std::vector<NamedAnim> animations;
-};
+//bump when a change to the importer changes what it produces, so cached imports are redone
+constexpr uint32_t g_fbx_importer_version = 1;
+//the importer's version and settings, imports made by another version or with other settings aren't reused from the cache
+uint64_t fbx_import_settings_hash();
 
 class FBXManagerWrapper
 {
@@ -45,4 +30,10 @@ public:
 
 private:
     FbxManager* m_manager;
-};
\ No newline at end of file
+};
+
+//loads the files on the job system's threads, the results are in the order of the paths whichever order they finish in
+//fbx scenes can't be shared between threads, so each task loads its own copy of a scene with its own manager
+//a file's anim stacks are split into runs of frames that are baked on separate copies, so one file with long clips doesn't hold up the rest
+//a file that can't be read, or whose anim stacks can't all be baked, has empty content as a failed load_file_content does
+std::vector<FbxFileContent> load_file_contents(std::span<const std::filesystem::path> paths, jobs::JobSystem& job_system);
\ No newline at end of file
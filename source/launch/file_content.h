@@ -0,0 +1,55 @@
+#pragma once
+
+#include "animation/animation.h"
+
+#include "file/mapped_file.h"
+
+#include <glad/glad.h>
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+struct SkinnedVertex
+{
+    geom::Vector3 pos;
+    int skinned_bone_index;
+
+    static void apply_attributes()
+    {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribIPointer(1, 1, GL_INT, sizeof(SkinnedVertex), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+};
+
+//what's read from an fbx file, or from the native files asset_convert writes for it
+struct FbxFileContent
+{
+    struct NamedAnim
+    {
+        std::string name;
+        anim::Animation animation;
+    };
+    std::vector<SkinnedVertex> vertices;
+    std::vector<unsigned int> indices;
+
+    std::unique_ptr<anim::Skeleton> skeleton;
+    std::vector<NamedAnim> animations;
+
+    //files other than the fbx file that it references, the import cache converts the fbx file again when one of them changes
+    //only filled by an import, not when reading native content
+    std::vector<std::filesystem::path> dependencies;
+
+    //native content is used in place in its mapped file, the mesh is viewed rather than copied into the vectors
+    //and the animations sample their keyframes from it
+    file::MappedFile mapping;
+    std::span<const SkinnedVertex> mapped_vertices;
+    std::span<const unsigned int> mapped_indices;
+
+    std::span<const SkinnedVertex> mesh_vertices() const { return mapping.is_open() ? mapped_vertices : std::span<const SkinnedVertex>(vertices); }
+    std::span<const unsigned int> mesh_indices() const { return mapping.is_open() ? mapped_indices : std::span<const unsigned int>(indices); }
+};
\ No newline at end of file
@@ -1,14 +1,22 @@
+#include "asset_manager.h"
 #include "fbx_wrapper.h"
+#include "native_content.h"
 
 #include "maths/vector3.h"
 
 #include "graphics/camera.h"
 #include "graphics/core_shaders.h"
 
+#include "animation/lod.h"
 #include "animation/pose.h"
+#include "animation/sampling_cache.h"
 
 #include "file/file_scanner.h"
 
+#include "jobs/job_system.h"
+
+#include "alloc/arena.h"
+
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 #include "imgui/imgui_impl_glfw.h"
@@ -19,6 +27,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <string>
 
 
 //vv TEMP vv
@@ -76,8 +85,130 @@ void resize_callback(GLFWwindow* window, int width, int height)
 
 //^^ TEMP ^^
 
-int main()
+namespace
 {
+    bool same_content(const FbxFileContent& lhs, const FbxFileContent& rhs)
+    {
+        auto same_vertex = [](const SkinnedVertex& l, const SkinnedVertex& r)
+        {
+            return l.pos == r.pos && l.skinned_bone_index == r.skinned_bone_index;
+        };
+        auto lhs_vertices = lhs.mesh_vertices();
+        auto rhs_vertices = rhs.mesh_vertices();
+        auto lhs_indices = lhs.mesh_indices();
+        auto rhs_indices = rhs.mesh_indices();
+        if (!std::equal(lhs_vertices.begin(), lhs_vertices.end(), rhs_vertices.begin(), rhs_vertices.end(), same_vertex)
+            || !std::equal(lhs_indices.begin(), lhs_indices.end(), rhs_indices.begin(), rhs_indices.end())
+            || !lhs.skeleton != !rhs.skeleton
+            || (lhs.skeleton && !anim::Skeleton::equivalent(*lhs.skeleton, *rhs.skeleton))
+            || lhs.animations.size() != rhs.animations.size())
+        {
+            return false;
+        }
+
+        for (int i = 0; i < (int)lhs.animations.size(); ++i)
+        {
+            const auto& l = lhs.animations[i];
+            const auto& r = rhs.animations[i];
+            if (l.name != r.name || l.animation.key_frame_count() != r.animation.key_frame_count())
+            {
+                return false;
+            }
+            for (int key_frame = 0; key_frame < l.animation.key_frame_count(); ++key_frame)
+            {
+                auto l_translations = l.animation.key_frame_translations(key_frame);
+                auto r_translations = r.animation.key_frame_translations(key_frame);
+                auto l_rotations = l.animation.key_frame_rotations(key_frame);
+                auto r_rotations = r.animation.key_frame_rotations(key_frame);
+                if (l.animation.key_times()[key_frame] != r.animation.key_times()[key_frame]
+                    || !std::equal(l_translations.begin(), l_translations.end(), r_translations.begin(), r_translations.end())
+                    || !std::equal(l_rotations.begin(), l_rotations.end(), r_rotations.begin(), r_rotations.end()))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //times loading every fbx file in the directory one after another and on the job system, and checks both give the same content
+    int run_import_bench(const std::filesystem::path& directory)
+    {
+        auto fbx_files = file::fbx_paths(directory);
+        std::cout << "Importing " << fbx_files.size() << " files from " << directory << "\n";
+
+        auto serial_start = std::chrono::steady_clock::now();
+        std::vector<FbxFileContent> serial;
+        {
+            FBXManagerWrapper fbx_manager;
+            for (auto& fbx_file : fbx_files)
+            {
+                serial.push_back(fbx_manager.load_file_content(fbx_file.string().c_str()));
+            }
+        }
+        std::chrono::duration<double, std::milli> serial_time = std::chrono::steady_clock::now() - serial_start;
+
+        auto parallel_start = std::chrono::steady_clock::now();
+        jobs::JobSystem job_system;
+        std::vector<FbxFileContent> parallel = load_file_contents(fbx_files, job_system);
+        std::chrono::duration<double, std::milli> parallel_time = std::chrono::steady_clock::now() - parallel_start;
+
+        //a start with an empty import cache writes every import to it, and the next start reads them back without the fbx sdk
+        auto cache_directory = std::filesystem::temp_directory_path() / "launch_import_bench_cache";
+        std::filesystem::remove_all(cache_directory);
+        auto cold_start = std::chrono::steady_clock::now();
+        {
+            file::ImportCache cache = open_import_cache(fbx_import_settings_hash(), cache_directory);
+            for (int i = 0; i < (int)fbx_files.size(); ++i)
+            {
+                cache.add(fbx_files[i], parallel[i].dependencies, [&](const std::filesystem::path& path) { return write_native_content(parallel[i], path); });
+            }
+            cache.save();
+        }
+        std::chrono::duration<double, std::milli> cold_time = std::chrono::steady_clock::now() - cold_start + parallel_time;
+
+        auto warm_start = std::chrono::steady_clock::now();
+        std::vector<FbxFileContent> cached(fbx_files.size());
+        bool all_cached = true;
+        {
+            file::ImportCache cache = open_import_cache(fbx_import_settings_hash(), cache_directory);
+            for (int i = 0; i < (int)fbx_files.size(); ++i)
+            {
+                auto path = cache.find(fbx_files[i]);
+                all_cached &= !path.empty() && read_native_content(path, cached[i]);
+            }
+        }
+        std::chrono::duration<double, std::milli> warm_time = std::chrono::steady_clock::now() - warm_start;
+
+        bool matches = serial.size() == parallel.size() && all_cached;
+        for (int i = 0; matches && i < (int)serial.size(); ++i)
+        {
+            matches = same_content(serial[i], parallel[i]) && same_content(serial[i], cached[i]);
+            if (!matches)
+            {
+                std::cout << "Mismatch in " << fbx_files[i] << "\n";
+            }
+        }
+
+        std::cout << "serial: " << serial_time.count() << "ms\n";
+        std::cout << "parallel (" << job_system.thread_count() << " threads): " << parallel_time.count() << "ms\n";
+        std::cout << "speedup: " << serial_time.count() / parallel_time.count() << "x\n";
+        std::cout << "cold start, parallel import and writing the cache: " << cold_time.count() << "ms\n";
+        std::cout << "warm start, hits for every file read from the cache: " << warm_time.count() << "ms\n";
+        cached.clear();
+        std::filesystem::remove_all(cache_directory);
+        return matches ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    //launch --import-bench [directory] times importing the assets without opening a window
+    if (argc > 1 && std::string(argv[1]) == "--import-bench")
+    {
+        return run_import_bench(argc > 2 ? std::filesystem::path(argv[2]) : file::g_fbx_path);
+    }
+
     glfwInit();
 
     //window
@@ -111,38 +242,32 @@ int main()
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 330 core");
 
-    //setup draw info/assets
-    auto fbx_files = file::fbx_paths();
-    FBXManagerWrapper fbx_manager;
-    struct Character
-    {
-        FbxFileContent file_content;
-        graphics::VertexArray<SkinnedVertex> vao;
-    };
-    std::vector<Character> characters;
-    for (auto& fbx_file : fbx_files)
-    {
-        auto filepath = fbx_file.string();
-        auto file_content = fbx_manager.load_file_content(filepath.c_str());
-        auto vao = graphics::VertexArray<SkinnedVertex>(
-            graphics::VertexBuffer(file_content.vertices),
-            file_content.indices.data(),
-            (int)file_content.indices.size());
-        characters.push_back({ std::move(file_content), std::move(vao) });
-    }
+    //animation is evaluated for every instance at once, spread over a thread per core
+    jobs::JobSystem job_system;
+
+    //only the file names are found up front, each file is loaded in the background the first time an instance uses it
+    AssetManager asset_manager;
 
     //set up shaders
     graphics::UnskinnedMeshShader<SkinnedVertex> unskinned_shader;
     graphics::SkinnedMeshShader<SkinnedVertex> skinned_shader;
     graphics::DebugShader debug_shader;
 
+    anim::LodSettings lod_settings;
+    //instances on the same clip at the same time share one sampled pose
+    anim::SamplingCache sampling_cache;
+    //transient data lives for the frame it's made in and the next, so a steady state frame doesn't allocate
+    alloc::FrameArena frame_arena(1 << 20);
+
+    //the skinning palette takes each joint from its bind pose position to its posed one
     auto draw_skeleton = [&](
         const anim::Skeleton& skeleton,
-        const std::vector<geom::Matrix44>& matrices,
+        std::span<const geom::Matrix44> palette,
         const geom::Matrix44& world)
     {
-        _ASSERT(skeleton.bones.size() == matrices.size());
-        for (int i = 0; i < matrices.size(); ++i)
+        _ASSERT(skeleton.bones.size() == palette.size());
+        auto joint = [&](int i) { return world * (palette[i] * skeleton.bones[i].global_transform.translation); };
+        for (int i = 0; i < palette.size(); ++i)
         {
             const auto& bone = skeleton.bones[i];
             if (bone.parent_index == -1)
@@ -151,8 +276,29 @@ int main()
             }
             debug_shader.draw_line(
                 g_camera, 
-                world * matrices[i].translation(),
-                world * matrices[bone.parent_index].translation());
+                joint(i),
+                joint(bone.parent_index));
+        }
+    };
+
+    //drawn in place of an instance until its character is loaded, a box about the size of a person standing on its origin
+    auto draw_placeholder = [&](const geom::Matrix44& world)
+    {
+        geom::Vector3 corners[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            geom::Vector3 corner = { i & 1 ? 0.25f : -0.25f, i & 2 ? 1.8f : 0.f, i & 4 ? 0.25f : -0.25f };
+            corners[i] = world * corner;
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            for (int axis = 1; axis < 8; axis <<= 1)
+            {
+                if (!(i & axis))
+                {
+                    debug_shader.draw_line(g_camera, corners[i], corners[i | axis]);
+                }
+            }
         }
     };
 
@@ -162,6 +308,11 @@ int main()
         using namespace std::chrono_literals;
         auto update_start_time = std::chrono::system_clock::now();
 
+        frame_arena.begin_frame();
+
+        //meshes of characters that finished loading since the last frame are uploaded before anything asks for them
+        asset_manager.upload_loaded();
+
         //window events
         glfwPollEvents();
         if (glfwWindowShouldClose(window))
@@ -211,6 +362,7 @@ int main()
             Type type = RefPose;
             int mesh_index = 0;
             int anim_index = 0;
+            anim::LodState lod;
             geom::Vector3 translation = geom::Vector3::zero();
             geom::Vector3 euler = geom::Vector3::zero();
             geom::Vector3 scale = geom::Vector3::one();
@@ -218,25 +370,122 @@ int main()
             geom::Vector3 anim_mod_translation = geom::Vector3::zero();
             geom::Vector3 anim_mod_euler = geom::Vector3::zero();
 
+            //the palette drawn this frame, either shared from the sampling cache or the instance's own copy
+            //instances that skip frames keep a copy of their last update, it only grows so a steady state frame doesn't allocate
+            std::span<const geom::Matrix44> palette;
+            std::vector<geom::Matrix44> matrix_stack;
+            int cache_entry = -1;
+            //mesh and clip the palette was last sampled for, changing either forces an update so the old palette isn't drawn
+            int sampled_mesh = -1;
+            int sampled_anim = -1;
+
             int id = next_id();
             static int next_id() { static int id = 0; return id++; }
         };
         static std::vector<Instance> s_instances;
 
-        ImGui::Begin("Instances");
-        if (ImGui::Button("Add"))
+        //sample every animated instance before drawing any of them
+        sampling_cache.begin_frame();
+        for (auto& instance : s_instances)
         {
-            s_instances.push_back({});
+            instance.cache_entry = -1;
+            const LoadedAsset* character = asset_manager.request(instance.mesh_index);
+            if (character == nullptr)
+            {
+                continue;
+            }
+            const anim::Skeleton& skeleton = *character->file_content.skeleton;
+            instance.matrix_stack.resize(skeleton.bones.size());
+            instance.palette = instance.matrix_stack;
+            if (instance.mesh_index != instance.sampled_mesh || instance.anim_index != instance.sampled_anim)
+            {
+                instance.sampled_mesh = instance.mesh_index;
+                instance.sampled_anim = instance.anim_index;
+                instance.lod.level = -1;
+            }
+
+            bool animated = instance.type == Instance::SkinnedMesh || instance.type == Instance::SkinnedPose;
+            if (animated && character->file_content.animations.size() > instance.anim_index)
+            {
+                //distant instances animate fewer bones, less often, and the palette from their last update is drawn in between
+                float distance = (instance.translation - g_camera.translation).magnitude();
+                if (!anim::update_lod(lod_settings, distance, instance.lod))
+                {
+                    continue;
+                }
+                const anim::LodLevel& lod = lod_settings.levels[instance.lod.level];
+
+                instance.cache_entry = sampling_cache.request(
+                    character->file_content.animations[instance.anim_index].animation,
+                    s_time,
+                    true,
+                    &character->bone_lods,
+                    std::min(lod.bone_lod, character->bone_lods.level_count() - 1),
+                    lod.nearest_key);
+            }
+            else
+            {
+                //without an animation the identity palette draws the bind pose
+                std::fill(instance.matrix_stack.begin(), instance.matrix_stack.end(), geom::Matrix44::identity());
+            }
         }
-        int to_delete = -1;
-        for (int i = 0; i < s_instances.size(); ++i)
+        sampling_cache.evaluate(job_system);
+        for (auto& instance : s_instances)
         {
-            auto& instance = s_instances[i];
-            if (instance.mesh_index >= characters.size())
+            if (instance.cache_entry == -1)
             {
                 continue;
             }
-            auto& character = characters[instance.mesh_index];
+            auto shared_palette = sampling_cache.skinning_palette(instance.cache_entry);
+            if (lod_settings.levels[instance.lod.level].update_interval == 1)
+            {
+                instance.palette = shared_palette;
+            }
+            else
+            {
+                std::copy(shared_palette.begin(), shared_palette.end(), instance.matrix_stack.begin());
+            }
+        }
+
+        ImGui::Begin("Animation LOD");
+        bool lod_settings_changed = false;
+        for (int i = 0; i < lod_settings.levels.size(); ++i)
+        {
+            auto& level = lod_settings.levels[i];
+            ImGui::PushID(i);
+            ImGui::Text("Level %d", i);
+            lod_settings_changed |= ImGui::DragFloat("Distance", &level.distance, 1.f, 0.f, 1000.f);
+            lod_settings_changed |= ImGui::InputInt("Bone LOD", &level.bone_lod);
+            lod_settings_changed |= ImGui::InputInt("Update Interval", &level.update_interval);
+            lod_settings_changed |= ImGui::Checkbox("Nearest Key", &level.nearest_key);
+            level.bone_lod = std::max(level.bone_lod, 0);
+            level.update_interval = std::max(level.update_interval, 1);
+            ImGui::PopID();
+        }
+        ImGui::End();
+        if (lod_settings_changed)
+        {
+            //an instance sharing the cache's palette has nothing in its own copy to draw on frames it skips under the new settings
+            for (auto& instance : s_instances)
+            {
+                instance.lod.level = -1;
+            }
+        }
+
+        ImGui::Begin("Frame Memory");
+        ImGui::Text("Arena peak %zu of %zu bytes", frame_arena.peak_usage(), frame_arena.current().capacity());
+        ImGui::End();
+
+        //skeleton lines are collected while drawing the instances and drawn together afterwards
+        debug_shader.begin(frame_arena.current());
+        ImGui::Begin("Instances");
+        //added after drawing, so the new instance is sampled before it's first drawn
+        bool add_instance = ImGui::Button("Add");
+        int to_delete = -1;
+        for (int i = 0; i < s_instances.size(); ++i)
+        {
+            auto& instance = s_instances[i];
+            const LoadedAsset* character = asset_manager.request(instance.mesh_index);
 
             //draw the instance
             auto world =
@@ -246,37 +495,29 @@ int main()
                 geom::create_x_rotation_matrix_44(instance.euler.x * geom::PI / 180.f) *
                 geom::create_scale_matrix_44(instance.scale);
 
-            auto create_matrix_stack = [&]()
+            if (character == nullptr)
+            {
+                draw_placeholder(world);
+            }
+            else
             {
-                std::vector<geom::Matrix44> mat_stack;
-                if (character.file_content.animations.size() > instance.anim_index)
+                const anim::Skeleton& skeleton = *character->file_content.skeleton;
+
+                switch (instance.type)
                 {
-                    mat_stack = character.file_content.animations[instance.anim_index].animation.get_pose(s_time, true).get_matrix_stack();
-                }
-                else
+                case Instance::SkinnedMesh:
                 {
-                    mat_stack.resize(character.file_content.skeleton->bones.size(), geom::Matrix44::identity());
+                    skinned_shader.draw(character->vao, g_camera.calculate_camera_matrix(), world, instance.palette);
+                    break;
+                }
+                case Instance::UnskinnedMesh:
+                    unskinned_shader.draw(character->vao, g_camera.calculate_camera_matrix(), world);
+                    break;
+                case Instance::SkinnedPose:
+                case Instance::RefPose:
+                    draw_skeleton(skeleton, instance.palette, world);
+                    break;
                 }
-
-                return mat_stack;
-            };
-
-            switch (instance.type)
-            {
-            case Instance::SkinnedMesh:
-            {
-                skinned_shader.draw(character.vao, g_camera.calculate_camera_matrix(), world, create_matrix_stack(), character.file_content.skeleton->inv_matrix_stack);
-                break;
-            }
-            case Instance::UnskinnedMesh:
-                unskinned_shader.draw(character.vao, g_camera.calculate_camera_matrix(), world);
-                break;
-            case Instance::SkinnedPose:
-                draw_skeleton(*character.file_content.skeleton, create_matrix_stack(), world);
-                break;
-            case Instance::RefPose:
-                draw_skeleton(*character.file_content.skeleton, character.file_content.skeleton->matrix_stack(), world);
-                break;
             }
 
             //add edit details to imgui window
@@ -293,6 +534,12 @@ int main()
                 ImGui::InputInt("Type", &type_int);
                 instance.type = (Instance::Type)type_int;
                 ImGui::InputInt("Mesh", &instance.mesh_index);
+                if (instance.mesh_index >= 0 && instance.mesh_index < asset_manager.asset_count())
+                {
+                    const char* states[] = { "Unloaded", "Loading", "Ready", "Failed" };
+                    ImGui::Text("%s: %s", asset_manager.path(instance.mesh_index).filename().string().c_str(),
+                        states[(int)asset_manager.state(instance.mesh_index)]);
+                }
                 ImGui::InputInt("Anim", &instance.anim_index);
                 ImGui::DragFloat3("Position", &instance.translation.x, 0.2f);
                 ImGui::DragFloat3("Rotation", &instance.euler.x, 5.f);
@@ -308,10 +555,15 @@ int main()
             }
         }
         ImGui::End();
+        debug_shader.end(g_camera);
         if (to_delete != -1)
         {
             s_instances.erase(s_instances.begin() + to_delete);
         }
+        if (add_instance)
+        {
+            s_instances.push_back({});
+        }
 
         //ImGui end frame
         ImGui::Render();
@@ -0,0 +1,88 @@
+#include "native_content.h"
+
+#include "animation/blob.h"
+
+#include "file/blob.h"
+#include "file/hash.h"
+
+namespace
+{
+    constexpr file::FileHeader g_asset_header = { file::make_tag("ASET"), g_native_content_version };
+
+    struct AssetBlob
+    {
+        anim::SkeletonBlob skeleton;
+        file::BlobArray<SkinnedVertex> vertices;
+        file::BlobArray<unsigned int> indices;
+        file::BlobArray<anim::ClipBlob> clips;
+    };
+}
+
+file::ImportCache open_import_cache(uint64_t import_settings_hash, const std::filesystem::path& directory)
+{
+    return file::ImportCache(directory, ".asset", file::hash_combine(import_settings_hash, g_native_content_version));
+}
+
+bool write_native_content(const FbxFileContent& content, const std::filesystem::path& path)
+{
+    if (!content.skeleton)
+    {
+        return false;
+    }
+
+    //files are named after their content, so a valid file already there holds the same and may be mapped by a loaded asset
+    FbxFileContent existing;
+    if (read_native_content(path, existing))
+    {
+        return true;
+    }
+
+    file::BlobWriter writer(g_asset_header);
+    AssetBlob root;
+    root.skeleton = anim::add_skeleton(writer, *content.skeleton);
+    root.vertices = writer.add_array(content.mesh_vertices());
+    root.indices = writer.add_array(content.mesh_indices());
+    std::vector<anim::ClipBlob> clips;
+    for (const auto& named_anim : content.animations)
+    {
+        clips.push_back(anim::add_clip(writer, named_anim.animation, named_anim.name));
+    }
+    root.clips = writer.add_array(std::span<const anim::ClipBlob>(clips));
+    writer.set_root(root);
+    return writer.save(path);
+}
+
+bool read_native_content(const std::filesystem::path& path, FbxFileContent& out)
+{
+    FbxFileContent content;
+    content.mapping = file::MappedFile(path);
+    file::BlobView view(content.mapping.bytes(), g_asset_header);
+    const AssetBlob* root = view.root<AssetBlob>();
+    if (root == nullptr)
+    {
+        return false;
+    }
+
+    content.skeleton = std::make_unique<anim::Skeleton>();
+    content.mapped_vertices = view.array(root->vertices);
+    content.mapped_indices = view.array(root->indices);
+    if (!anim::read_skeleton(view, root->skeleton, *content.skeleton) || content.mapped_vertices.empty() || content.mapped_indices.empty())
+    {
+        return false;
+    }
+
+    auto clips = view.array(root->clips);
+    content.animations.reserve(clips.size());
+    for (const anim::ClipBlob& clip : clips)
+    {
+        auto animation = anim::view_clip(view, clip, *content.skeleton);
+        if (!animation)
+        {
+            return false;
+        }
+        content.animations.push_back({ std::string(view.string(clip.name)), std::move(*animation) });
+    }
+
+    out = std::move(content);
+    return true;
+}
\ No newline at end of file
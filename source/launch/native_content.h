@@ -0,0 +1,23 @@
+#pragma once
+
+#include "file_content.h"
+
+#include "file/filepaths.h"
+#include "file/import_cache.h"
+
+#include <cstdint>
+#include <filesystem>
+
+//the skeleton, mesh and clips of an fbx file in a blob of their own, written when the fbx file is imported and read without the fbx sdk
+//the blob is mapped and used in place, so reading it costs little more than the skeleton's copy and the pages the mesh upload touches
+
+//bump when the layout of the blob changes
+constexpr uint32_t g_native_content_version = 2;
+
+//the blobs converted from fbx files, kept under the cache directory and keyed on the importer's settings and the blob's version as well as the files
+file::ImportCache open_import_cache(uint64_t import_settings_hash, const std::filesystem::path& directory = file::g_import_cache_path);
+
+//false if the file couldn't be written, a valid file already at the path is kept as the import cache gives the same content the same path
+bool write_native_content(const FbxFileContent& content, const std::filesystem::path& path);
+//false if the file is missing or isn't a blob of this version
+bool read_native_content(const std::filesystem::path& path, FbxFileContent& out);
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "constants.h"
+#include <math.h>
+
+//polynomial approximations of the trig functions used by rotation interpolation
+//the error bounds are the largest absolute errors measured against the double precision library functions
+
+namespace geom::approx
+{
+    //sin(x) / x for |x| <= pi / 2, max error 3.5e-6, defined at zero so ratios of sines need no special case there
+    constexpr float sinc(float x);
+    //max error 7.5e-7 for |x| <= 1000, beyond that the float input itself is coarser than the error
+    constexpr float sin(float x);
+    constexpr float cos(float x);
+    //inputs outside [-1, 1] are clamped, max error 4.5e-7
+    float acos(float x);
+}
+
+//inline definitions
+namespace geom::approx
+{
+    namespace detail
+    {
+        //minimax coefficients for sin on [-pi / 2, pi / 2], as odd powers of x
+        constexpr float g_sin_1 = 0.9999966f;
+        constexpr float g_sin_3 = -0.16664824f;
+        constexpr float g_sin_5 = 0.00830629f;
+        constexpr float g_sin_7 = -0.00018363f;
+
+        //pi split in two so that k * pi_high is exact for the multiples of pi used in range reduction
+        constexpr float g_pi_high = 3.140625f;
+        constexpr float g_pi_low = 9.67653589793e-4f;
+
+        //abramowitz and stegun 4.4.46, acos(x) = sqrt(1 - x) * polynomial(x) for x in [0, 1]
+        constexpr float g_acos_coefficients[] = {
+            1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+            0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f
+        };
+    }
+
+    constexpr float sinc(float x)
+    {
+        float x2 = x * x;
+        return detail::g_sin_1 + x2 * (detail::g_sin_3 + x2 * (detail::g_sin_5 + x2 * detail::g_sin_7));
+    }
+
+    constexpr float sin(float x)
+    {
+        //reduce to r in [-pi / 2, pi / 2] where x = r + k * pi, sin(x) = (-1)^k * sin(r)
+        long long k = (long long)(x * (1.f / PI) + (x < 0.f ? -0.5f : 0.5f));
+        float r = (x - (float)k * detail::g_pi_high) - (float)k * detail::g_pi_low;
+        float result = r * sinc(r);
+        return (k & 1) ? -result : result;
+    }
+
+    constexpr float cos(float x)
+    {
+        //sin(x + pi / 2), with the quarter turn added after the reduction so it costs no precision for large x
+        float shifted = x * (1.f / PI) + 0.5f;
+        long long k = (long long)(shifted + (shifted < 0.f ? -0.5f : 0.5f));
+        float r = ((x - (float)k * detail::g_pi_high) - (float)k * detail::g_pi_low) + 0.5f * PI;
+        float result = r * sinc(r);
+        return (k & 1) ? -result : result;
+    }
+
+    inline float acos(float x)
+    {
+        float a = fminf(fabsf(x), 1.f);
+        float polynomial = detail::g_acos_coefficients[7];
+        for (int i = 6; i >= 0; --i)
+        {
+            polynomial = polynomial * a + detail::g_acos_coefficients[i];
+        }
+        float result = sqrtf(1.f - a) * polynomial;
+
+        //acos(-x) = pi - acos(x)
+        return x < 0.f ? PI - result : result;
+    }
+}
\ No newline at end of file
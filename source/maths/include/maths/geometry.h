@@ -4,36 +4,25 @@
 #include "matrix.h"
 #include "quaternion.h"
 
+#include <span>
+
 //this file handles combined functionality between vectors, matrices, quaternions
 
 namespace geom
 {
     //operations
 
-    inline Vector3 operator*(const Matrix44& mat, Vector3 vec)
+    //kept scalar, the simd kernel was slower than this for a single point (see maths_bench)
+    constexpr Vector3 operator*(const Matrix44& mat, Vector3 vec)
     {
-        Vector3 result;
-
-        result.x =
-            mat.get(0, 0) * vec.x +
-            mat.get(0, 1) * vec.y +
-            mat.get(0, 2) * vec.z +
-            mat.get(0, 3);
-        result.y =
-            mat.get(1, 0) * vec.x +
-            mat.get(1, 1) * vec.y +
-            mat.get(1, 2) * vec.z +
-            mat.get(1, 3);
-        result.z =
-            mat.get(2, 0) * vec.x +
-            mat.get(2, 1) * vec.y +
-            mat.get(2, 2) * vec.z +
-            mat.get(2, 3);
-
-        return result;
+        return {
+            mat.get(0, 0) * vec.x + mat.get(0, 1) * vec.y + mat.get(0, 2) * vec.z + mat.get(0, 3),
+            mat.get(1, 0) * vec.x + mat.get(1, 1) * vec.y + mat.get(1, 2) * vec.z + mat.get(1, 3),
+            mat.get(2, 0) * vec.x + mat.get(2, 1) * vec.y + mat.get(2, 2) * vec.z + mat.get(2, 3)
+        };
     }
 
-    inline Vector3 operator*(const Matrix34& mat, Vector3 vec)
+    constexpr Vector3 operator*(const Matrix34& mat, Vector3 vec)
     {
         Vector3 result;
 
@@ -56,15 +45,29 @@ namespace geom
         return result;
     }
 
-    inline Vector3 operator*(const Quaternion& q, Vector3 vec)
+    //rotates vec by a unit quaternion
+    constexpr Vector3 operator*(const Quaternion& q, Vector3 vec)
     {
-        Quaternion q_res = q * Quaternion{ vec.x, vec.y, vec.z, 0.f } *q.inverse();
-        return q_res.axis();
+        //expansion of q * vec * q^-1 that avoids the two quaternion products
+        Vector3 axis = q.axis();
+        Vector3 t = 2.f * Vector3::cross(axis, vec);
+        return vec + q.w * t + Vector3::cross(axis, t);
+    }
+
+    //transforms every point in the span by mat, in and out may be the same span
+    //a plain loop, compilers vectorise it as well as a hand written sse kernel does (see maths_bench)
+    inline void transform_points(const Matrix44& mat, std::span<const Vector3> in, std::span<Vector3> out)
+    {
+        _ASSERT(in.size() <= out.size());
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            out[i] = mat * in[i];
+        }
     }
 
     //conversions/constructions
 
-    inline Matrix34 create_translation_matrix_34(Vector3 vec)
+    constexpr Matrix34 create_translation_matrix_34(Vector3 vec)
     {
         auto result = Matrix34::identity();
         result.get(0, 3) = vec.x;
@@ -72,7 +75,7 @@ namespace geom
         result.get(2, 3) = vec.z;
         return result;
     }
-    inline Matrix44 create_translation_matrix_44(Vector3 vec)
+    constexpr Matrix44 create_translation_matrix_44(Vector3 vec)
     {
         auto result = Matrix44::identity();
         result.get(0, 3) = vec.x;
@@ -80,7 +83,7 @@ namespace geom
         result.get(2, 3) = vec.z;
         return result;
     }
-    inline Matrix44 create_scale_matrix_44(Vector3 vec)
+    constexpr Matrix44 create_scale_matrix_44(Vector3 vec)
     {
         auto result = Matrix44::identity();
         result.get(0, 0) = vec.x;
@@ -142,7 +145,7 @@ namespace geom
 
         return result;
     }
-    inline Matrix44 create_rotation_matrix_from_quaternion(const Quaternion& q)
+    constexpr Matrix44 create_rotation_matrix_from_quaternion(const Quaternion& q)
     {
         Matrix44 result;
 
@@ -169,6 +172,67 @@ namespace geom
         return result;
     }
 
+    //rotation then translation, built directly rather than by multiplying a translation and rotation matrix
+    constexpr Matrix34 create_transform_matrix_34(Vector3 translation, const Quaternion& q)
+    {
+        Matrix34 result;
+
+        result.get(0, 0) = 2.f * (q.w * q.w + q.x * q.x) - 1;
+        result.get(0, 1) = 2.f * (q.x * q.y - q.w * q.z);
+        result.get(0, 2) = 2.f * (q.x * q.z + q.w * q.y);
+        result.get(0, 3) = translation.x;
+
+        result.get(1, 0) = 2.f * (q.x * q.y + q.w * q.z);
+        result.get(1, 1) = 2.f * (q.w * q.w + q.y * q.y) - 1;
+        result.get(1, 2) = 2.f * (q.y * q.z - q.w * q.x);
+        result.get(1, 3) = translation.y;
+
+        result.get(2, 0) = 2.f * (q.x * q.z - q.w * q.y);
+        result.get(2, 1) = 2.f * (q.y * q.z + q.w * q.x);
+        result.get(2, 2) = 2.f * (q.w * q.w + q.z * q.z) - 1;
+        result.get(2, 3) = translation.z;
+
+        return result;
+    }
+    constexpr Matrix44 create_transform_matrix_44(Vector3 translation, const Quaternion& q)
+    {
+        Matrix44 result;
+
+        result.get(0, 0) = 2.f * (q.w * q.w + q.x * q.x) - 1;
+        result.get(0, 1) = 2.f * (q.x * q.y - q.w * q.z);
+        result.get(0, 2) = 2.f * (q.x * q.z + q.w * q.y);
+        result.get(0, 3) = translation.x;
+
+        result.get(1, 0) = 2.f * (q.x * q.y + q.w * q.z);
+        result.get(1, 1) = 2.f * (q.w * q.w + q.y * q.y) - 1;
+        result.get(1, 2) = 2.f * (q.y * q.z - q.w * q.x);
+        result.get(1, 3) = translation.y;
+
+        result.get(2, 0) = 2.f * (q.x * q.z - q.w * q.y);
+        result.get(2, 1) = 2.f * (q.y * q.z + q.w * q.x);
+        result.get(2, 2) = 2.f * (q.w * q.w + q.z * q.z) - 1;
+        result.get(2, 3) = translation.z;
+
+        result.get(3, 0) = 0.f;
+        result.get(3, 1) = 0.f;
+        result.get(3, 2) = 0.f;
+        result.get(3, 3) = 1.f;
+
+        return result;
+    }
+    constexpr Matrix44 create_matrix_44_from_affine(const Matrix34& mat)
+    {
+        Matrix44 result;
+        for (int column = 0; column < 4; ++column)
+        {
+            result.get(0, column) = mat.get(0, column);
+            result.get(1, column) = mat.get(1, column);
+            result.get(2, column) = mat.get(2, column);
+            result.get(3, column) = column == 3 ? 1.f : 0.f;
+        }
+        return result;
+    }
+
     inline Matrix44 create_projection_matrix_44(float aspect, float fov, float near, float far)
     {
         Matrix44 result;
@@ -198,7 +262,7 @@ namespace geom
         return result;
     }
 
-    inline Vector3 translation_from_matrix(const Matrix34& mat)
+    constexpr Vector3 translation_from_matrix(const Matrix34& mat)
     {
         return {
             mat.get(0, 3),
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "simd.h"
+
+#include <type_traits>
+
 namespace geom
 {
     //forward declarations
@@ -9,37 +13,45 @@ namespace geom
 
     //struct
 
+    //column major storage, sizes that fill whole sse registers are aligned so the simd kernels can use aligned loads
     template<int Rows, int Columns>
-    struct Matrix
+    struct alignas((Rows * Columns) % 4 == 0 ? 16 : alignof(float)) Matrix
     {
         float values[Rows * Columns];
 
-        static Matrix identity();
+        static constexpr Matrix identity();
+
+        constexpr int index(int row, int col) const;
+        constexpr float get(int row, int col) const;
+        constexpr float& get(int row, int col);
 
-        int index(int row, int col) const;
-        float get(int row, int col) const;
-        float& get(int row, int col);
+        constexpr float determinant() const requires(Rows == Columns);
+        constexpr Matrix<Rows - 1, Columns - 1> submatrix(int row, int col) const;
+        constexpr Matrix adjugate() const;
+        constexpr Matrix inverse() const;
+        constexpr Matrix inverse_generic() const;
+        constexpr Matrix transpose() const;
 
-        float determinant() const requires(Rows == Columns && Rows != 1);
-        float determinant() const;
-        Matrix<Rows - 1, Columns - 1> submatrix(int row, int col) const;
-        Matrix adjugate() const;
-        Matrix inverse() const;
-        Matrix transpose() const;
+        //cheaper inverses for transforms with an (implied) bottom row of (0,0,0,1)
+        constexpr Matrix affine_inverse() const requires(Columns == 4 && (Rows == 3 || Rows == 4));
+        constexpr Matrix rigid_inverse() const requires(Columns == 4 && (Rows == 3 || Rows == 4));
 
-        Vector3 translation() const;
+        constexpr Vector3 translation() const;
     };
 
     //operators
 
+    //square matrices use the normal product, 3x4 matrices are treated as affine with an implicit (0,0,0,1) bottom row
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs);
+    constexpr Matrix<Rows, Columns> multiply_scalar(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs);
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, float rhs);
+    constexpr Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs);
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(float lhs, const Matrix<Rows, Columns>& rhs);
+    constexpr Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, float rhs);
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator/(const Matrix<Rows, Columns>& lhs, float rhs);
+    constexpr Matrix<Rows, Columns> operator*(float lhs, const Matrix<Rows, Columns>& rhs);
+    template<int Rows, int Columns>
+    constexpr Matrix<Rows, Columns> operator/(const Matrix<Rows, Columns>& lhs, float rhs);
 
     //specialisation
     using Matrix44 = Matrix<4, 4>;
@@ -56,26 +68,91 @@ namespace geom
     //inline operator definitions
 
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs)
+    constexpr Matrix<Rows, Columns> multiply_scalar(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs)
     {
+        static_assert(Rows == Columns || (Rows == 3 && Columns == 4), "Matrix product is only defined for square or 3x4 affine matrices.");
+
         Matrix<Rows, Columns> result;
 
         for (int column = 0; column < Columns; ++column)
         {
             for (int row = 0; row < Rows; ++row)
             {
-                result.get(row, column) =
-                    lhs.get(row, 0) * rhs.get(0, column) +
-                    lhs.get(row, 1) * rhs.get(1, column) +
-                    lhs.get(row, 2) * rhs.get(2, column) +
-                    lhs.get(row, 3) * rhs.get(3, column);
+                //the implicit bottom row of an affine matrix only contributes to the translation column
+                float value = (Rows != Columns && column == Columns - 1) ? lhs.get(row, Columns - 1) : 0.f;
+                for (int i = 0; i < Rows; ++i)
+                {
+                    value += lhs.get(row, i) * rhs.get(i, column);
+                }
+                result.get(row, column) = value;
             }
         }
 
         return result;
     }
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, float rhs)
+    constexpr Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs)
+    {
+        return multiply_scalar(lhs, rhs);
+    }
+    template<>
+    constexpr Matrix44 operator*(const Matrix44& lhs, const Matrix44& rhs)
+    {
+        //intrinsics can't be evaluated at compile time
+        if (std::is_constant_evaluated())
+        {
+            return multiply_scalar(lhs, rhs);
+        }
+
+        Matrix44 result;
+        simd::multiply_44(lhs.values, rhs.values, result.values);
+        return result;
+    }
+    template<>
+    constexpr Matrix<3, 3> operator*(const Matrix<3, 3>& lhs, const Matrix<3, 3>& rhs)
+    {
+        Matrix<3, 3> result;
+
+        result.get(0, 0) = lhs.get(0, 0) * rhs.get(0, 0) + lhs.get(0, 1) * rhs.get(1, 0) + lhs.get(0, 2) * rhs.get(2, 0);
+        result.get(1, 0) = lhs.get(1, 0) * rhs.get(0, 0) + lhs.get(1, 1) * rhs.get(1, 0) + lhs.get(1, 2) * rhs.get(2, 0);
+        result.get(2, 0) = lhs.get(2, 0) * rhs.get(0, 0) + lhs.get(2, 1) * rhs.get(1, 0) + lhs.get(2, 2) * rhs.get(2, 0);
+
+        result.get(0, 1) = lhs.get(0, 0) * rhs.get(0, 1) + lhs.get(0, 1) * rhs.get(1, 1) + lhs.get(0, 2) * rhs.get(2, 1);
+        result.get(1, 1) = lhs.get(1, 0) * rhs.get(0, 1) + lhs.get(1, 1) * rhs.get(1, 1) + lhs.get(1, 2) * rhs.get(2, 1);
+        result.get(2, 1) = lhs.get(2, 0) * rhs.get(0, 1) + lhs.get(2, 1) * rhs.get(1, 1) + lhs.get(2, 2) * rhs.get(2, 1);
+
+        result.get(0, 2) = lhs.get(0, 0) * rhs.get(0, 2) + lhs.get(0, 1) * rhs.get(1, 2) + lhs.get(0, 2) * rhs.get(2, 2);
+        result.get(1, 2) = lhs.get(1, 0) * rhs.get(0, 2) + lhs.get(1, 1) * rhs.get(1, 2) + lhs.get(1, 2) * rhs.get(2, 2);
+        result.get(2, 2) = lhs.get(2, 0) * rhs.get(0, 2) + lhs.get(2, 1) * rhs.get(1, 2) + lhs.get(2, 2) * rhs.get(2, 2);
+
+        return result;
+    }
+    template<>
+    constexpr Matrix34 operator*(const Matrix34& lhs, const Matrix34& rhs)
+    {
+        Matrix34 result;
+
+        result.get(0, 0) = lhs.get(0, 0) * rhs.get(0, 0) + lhs.get(0, 1) * rhs.get(1, 0) + lhs.get(0, 2) * rhs.get(2, 0);
+        result.get(1, 0) = lhs.get(1, 0) * rhs.get(0, 0) + lhs.get(1, 1) * rhs.get(1, 0) + lhs.get(1, 2) * rhs.get(2, 0);
+        result.get(2, 0) = lhs.get(2, 0) * rhs.get(0, 0) + lhs.get(2, 1) * rhs.get(1, 0) + lhs.get(2, 2) * rhs.get(2, 0);
+
+        result.get(0, 1) = lhs.get(0, 0) * rhs.get(0, 1) + lhs.get(0, 1) * rhs.get(1, 1) + lhs.get(0, 2) * rhs.get(2, 1);
+        result.get(1, 1) = lhs.get(1, 0) * rhs.get(0, 1) + lhs.get(1, 1) * rhs.get(1, 1) + lhs.get(1, 2) * rhs.get(2, 1);
+        result.get(2, 1) = lhs.get(2, 0) * rhs.get(0, 1) + lhs.get(2, 1) * rhs.get(1, 1) + lhs.get(2, 2) * rhs.get(2, 1);
+
+        result.get(0, 2) = lhs.get(0, 0) * rhs.get(0, 2) + lhs.get(0, 1) * rhs.get(1, 2) + lhs.get(0, 2) * rhs.get(2, 2);
+        result.get(1, 2) = lhs.get(1, 0) * rhs.get(0, 2) + lhs.get(1, 1) * rhs.get(1, 2) + lhs.get(1, 2) * rhs.get(2, 2);
+        result.get(2, 2) = lhs.get(2, 0) * rhs.get(0, 2) + lhs.get(2, 1) * rhs.get(1, 2) + lhs.get(2, 2) * rhs.get(2, 2);
+
+        //the implicit bottom row of the rhs adds the lhs translation
+        result.get(0, 3) = lhs.get(0, 0) * rhs.get(0, 3) + lhs.get(0, 1) * rhs.get(1, 3) + lhs.get(0, 2) * rhs.get(2, 3) + lhs.get(0, 3);
+        result.get(1, 3) = lhs.get(1, 0) * rhs.get(0, 3) + lhs.get(1, 1) * rhs.get(1, 3) + lhs.get(1, 2) * rhs.get(2, 3) + lhs.get(1, 3);
+        result.get(2, 3) = lhs.get(2, 0) * rhs.get(0, 3) + lhs.get(2, 1) * rhs.get(1, 3) + lhs.get(2, 2) * rhs.get(2, 3) + lhs.get(2, 3);
+
+        return result;
+    }
+    template<int Rows, int Columns>
+    constexpr Matrix<Rows, Columns> operator*(const Matrix<Rows, Columns>& lhs, float rhs)
     {
         Matrix<Rows, Columns> matrix;
         for (int i = 0; i < Rows * Columns; ++i)
@@ -85,12 +162,12 @@ namespace geom
         return matrix;
     }
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator*(float lhs, const Matrix<Rows, Columns>& rhs)
+    constexpr Matrix<Rows, Columns> operator*(float lhs, const Matrix<Rows, Columns>& rhs)
     {
         return rhs * lhs;
     }
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> operator/(const Matrix<Rows, Columns>& lhs, float rhs)
+    constexpr Matrix<Rows, Columns> operator/(const Matrix<Rows, Columns>& lhs, float rhs)
     {
         _ASSERT(rhs != 0.f);
 
@@ -104,7 +181,7 @@ namespace geom
 
     //inline member definitions
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> Matrix<Rows, Columns>::identity()
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::identity()
     {
         Matrix mat;
         for (int column = 0; column < Columns; ++column)
@@ -119,25 +196,25 @@ namespace geom
     }
 
     template<int Rows, int Columns>
-    int Matrix<Rows, Columns>::index(int row, int col) const
+    constexpr int Matrix<Rows, Columns>::index(int row, int col) const
     {
         return row + col * Rows;
     }
 
     template<int Rows, int Columns>
-    float Matrix<Rows, Columns>::get(int row, int col) const
+    constexpr float Matrix<Rows, Columns>::get(int row, int col) const
     {
         return values[index(row, col)];
     }
 
     template<int Rows, int Columns>
-    float& Matrix<Rows, Columns>::get(int row, int col)
+    constexpr float& Matrix<Rows, Columns>::get(int row, int col)
     {
         return values[index(row, col)];
     }
 
     template<int Rows, int Columns>
-    float Matrix<Rows, Columns>::determinant() const requires(Rows == Columns && Rows != 1)
+    constexpr float Matrix<Rows, Columns>::determinant() const requires(Rows == Columns)
     {
         float result = 0;
         for (int row = 0; row < Rows; ++row)
@@ -149,13 +226,50 @@ namespace geom
     }
 
     template<>
-    inline float Matrix<1, 1>::determinant() const
+    constexpr float Matrix<1, 1>::determinant() const
     {
         return values[0];
     }
 
+    //small sizes are expanded fully rather than recursing through submatrices
+
+    template<>
+    constexpr float Matrix<2, 2>::determinant() const
+    {
+        return get(0, 0) * get(1, 1) - get(0, 1) * get(1, 0);
+    }
+
+    template<>
+    constexpr float Matrix<3, 3>::determinant() const
+    {
+        return
+            get(0, 0) * (get(1, 1) * get(2, 2) - get(1, 2) * get(2, 1)) +
+            get(0, 1) * (get(1, 2) * get(2, 0) - get(1, 0) * get(2, 2)) +
+            get(0, 2) * (get(1, 0) * get(2, 1) - get(1, 1) * get(2, 0));
+    }
+
+    template<>
+    constexpr float Matrix<4, 4>::determinant() const
+    {
+        float s0 = get(0, 0) * get(1, 1) - get(1, 0) * get(0, 1);
+        float s1 = get(0, 0) * get(1, 2) - get(1, 0) * get(0, 2);
+        float s2 = get(0, 0) * get(1, 3) - get(1, 0) * get(0, 3);
+        float s3 = get(0, 1) * get(1, 2) - get(1, 1) * get(0, 2);
+        float s4 = get(0, 1) * get(1, 3) - get(1, 1) * get(0, 3);
+        float s5 = get(0, 2) * get(1, 3) - get(1, 2) * get(0, 3);
+
+        float c5 = get(2, 2) * get(3, 3) - get(3, 2) * get(2, 3);
+        float c4 = get(2, 1) * get(3, 3) - get(3, 1) * get(2, 3);
+        float c3 = get(2, 1) * get(3, 2) - get(3, 1) * get(2, 2);
+        float c2 = get(2, 0) * get(3, 3) - get(3, 0) * get(2, 3);
+        float c1 = get(2, 0) * get(3, 2) - get(3, 0) * get(2, 2);
+        float c0 = get(2, 0) * get(3, 1) - get(3, 0) * get(2, 1);
+
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+
     template<int Rows, int Columns>
-    Matrix<Rows - 1, Columns - 1> Matrix<Rows, Columns>::submatrix(int i, int j) const
+    constexpr Matrix<Rows - 1, Columns - 1> Matrix<Rows, Columns>::submatrix(int i, int j) const
     {
         Matrix<Rows - 1, Columns - 1> result;
         for (int column = 0; column < Columns - 1; ++column)
@@ -173,7 +287,7 @@ namespace geom
     }
 
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> Matrix<Rows, Columns>::adjugate() const
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::adjugate() const
     {
         Matrix result;
 
@@ -190,13 +304,155 @@ namespace geom
     }
 
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> Matrix<Rows, Columns>::inverse() const
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::inverse() const
+    {
+        return inverse_generic();
+    }
+
+    //closed form 4x4 inverse using the 2x2 sub-determinants of the top and bottom row pairs
+    template<>
+    constexpr Matrix44 Matrix44::inverse() const
+    {
+        float s0 = get(0, 0) * get(1, 1) - get(1, 0) * get(0, 1);
+        float s1 = get(0, 0) * get(1, 2) - get(1, 0) * get(0, 2);
+        float s2 = get(0, 0) * get(1, 3) - get(1, 0) * get(0, 3);
+        float s3 = get(0, 1) * get(1, 2) - get(1, 1) * get(0, 2);
+        float s4 = get(0, 1) * get(1, 3) - get(1, 1) * get(0, 3);
+        float s5 = get(0, 2) * get(1, 3) - get(1, 2) * get(0, 3);
+
+        float c5 = get(2, 2) * get(3, 3) - get(3, 2) * get(2, 3);
+        float c4 = get(2, 1) * get(3, 3) - get(3, 1) * get(2, 3);
+        float c3 = get(2, 1) * get(3, 2) - get(3, 1) * get(2, 2);
+        float c2 = get(2, 0) * get(3, 3) - get(3, 0) * get(2, 3);
+        float c1 = get(2, 0) * get(3, 2) - get(3, 0) * get(2, 2);
+        float c0 = get(2, 0) * get(3, 1) - get(3, 0) * get(2, 1);
+
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        _ASSERT(det != 0.f);
+        float inv_det = 1.f / det;
+
+        Matrix44 result;
+
+        result.get(0, 0) = (get(1, 1) * c5 - get(1, 2) * c4 + get(1, 3) * c3) * inv_det;
+        result.get(0, 1) = (-get(0, 1) * c5 + get(0, 2) * c4 - get(0, 3) * c3) * inv_det;
+        result.get(0, 2) = (get(3, 1) * s5 - get(3, 2) * s4 + get(3, 3) * s3) * inv_det;
+        result.get(0, 3) = (-get(2, 1) * s5 + get(2, 2) * s4 - get(2, 3) * s3) * inv_det;
+
+        result.get(1, 0) = (-get(1, 0) * c5 + get(1, 2) * c2 - get(1, 3) * c1) * inv_det;
+        result.get(1, 1) = (get(0, 0) * c5 - get(0, 2) * c2 + get(0, 3) * c1) * inv_det;
+        result.get(1, 2) = (-get(3, 0) * s5 + get(3, 2) * s2 - get(3, 3) * s1) * inv_det;
+        result.get(1, 3) = (get(2, 0) * s5 - get(2, 2) * s2 + get(2, 3) * s1) * inv_det;
+
+        result.get(2, 0) = (get(1, 0) * c4 - get(1, 1) * c2 + get(1, 3) * c0) * inv_det;
+        result.get(2, 1) = (-get(0, 0) * c4 + get(0, 1) * c2 - get(0, 3) * c0) * inv_det;
+        result.get(2, 2) = (get(3, 0) * s4 - get(3, 1) * s2 + get(3, 3) * s0) * inv_det;
+        result.get(2, 3) = (-get(2, 0) * s4 + get(2, 1) * s2 - get(2, 3) * s0) * inv_det;
+
+        result.get(3, 0) = (-get(1, 0) * c3 + get(1, 1) * c1 - get(1, 2) * c0) * inv_det;
+        result.get(3, 1) = (get(0, 0) * c3 - get(0, 1) * c1 + get(0, 2) * c0) * inv_det;
+        result.get(3, 2) = (-get(3, 0) * s3 + get(3, 1) * s1 - get(3, 2) * s0) * inv_det;
+        result.get(3, 3) = (get(2, 0) * s3 - get(2, 1) * s1 + get(2, 2) * s0) * inv_det;
+
+        return result;
+    }
+
+    template<>
+    constexpr Matrix<3, 3> Matrix<3, 3>::inverse() const
+    {
+        float det = determinant();
+        _ASSERT(det != 0.f);
+        float inv_det = 1.f / det;
+
+        Matrix<3, 3> result;
+
+        result.get(0, 0) = (get(1, 1) * get(2, 2) - get(1, 2) * get(2, 1)) * inv_det;
+        result.get(1, 0) = (get(1, 2) * get(2, 0) - get(1, 0) * get(2, 2)) * inv_det;
+        result.get(2, 0) = (get(1, 0) * get(2, 1) - get(1, 1) * get(2, 0)) * inv_det;
+        result.get(0, 1) = (get(0, 2) * get(2, 1) - get(0, 1) * get(2, 2)) * inv_det;
+        result.get(1, 1) = (get(0, 0) * get(2, 2) - get(0, 2) * get(2, 0)) * inv_det;
+        result.get(2, 1) = (get(0, 1) * get(2, 0) - get(0, 0) * get(2, 1)) * inv_det;
+        result.get(0, 2) = (get(0, 1) * get(1, 2) - get(0, 2) * get(1, 1)) * inv_det;
+        result.get(1, 2) = (get(0, 2) * get(1, 0) - get(0, 0) * get(1, 2)) * inv_det;
+        result.get(2, 2) = (get(0, 0) * get(1, 1) - get(0, 1) * get(1, 0)) * inv_det;
+
+        return result;
+    }
+
+    template<int Rows, int Columns>
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::inverse_generic() const
     {
         return adjugate() / determinant();
     }
 
     template<int Rows, int Columns>
-    Matrix<Rows, Columns> Matrix<Rows, Columns>::transpose() const
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::affine_inverse() const requires(Columns == 4 && (Rows == 3 || Rows == 4))
+    {
+        //invert the upper 3x3 with cofactors, then the translation is -inverse * translation
+        float i00 = get(1, 1) * get(2, 2) - get(1, 2) * get(2, 1);
+        float i10 = get(1, 2) * get(2, 0) - get(1, 0) * get(2, 2);
+        float i20 = get(1, 0) * get(2, 1) - get(1, 1) * get(2, 0);
+
+        float det = get(0, 0) * i00 + get(0, 1) * i10 + get(0, 2) * i20;
+        _ASSERT(det != 0.f);
+        float inv_det = 1.f / det;
+
+        i00 *= inv_det;
+        i10 *= inv_det;
+        i20 *= inv_det;
+        float i01 = (get(0, 2) * get(2, 1) - get(0, 1) * get(2, 2)) * inv_det;
+        float i11 = (get(0, 0) * get(2, 2) - get(0, 2) * get(2, 0)) * inv_det;
+        float i21 = (get(0, 1) * get(2, 0) - get(0, 0) * get(2, 1)) * inv_det;
+        float i02 = (get(0, 1) * get(1, 2) - get(0, 2) * get(1, 1)) * inv_det;
+        float i12 = (get(0, 2) * get(1, 0) - get(0, 0) * get(1, 2)) * inv_det;
+        float i22 = (get(0, 0) * get(1, 1) - get(0, 1) * get(1, 0)) * inv_det;
+
+        float tx = get(0, 3);
+        float ty = get(1, 3);
+        float tz = get(2, 3);
+
+        Matrix result = identity();
+        result.get(0, 0) = i00;
+        result.get(1, 0) = i10;
+        result.get(2, 0) = i20;
+        result.get(0, 1) = i01;
+        result.get(1, 1) = i11;
+        result.get(2, 1) = i21;
+        result.get(0, 2) = i02;
+        result.get(1, 2) = i12;
+        result.get(2, 2) = i22;
+        result.get(0, 3) = -(i00 * tx + i01 * ty + i02 * tz);
+        result.get(1, 3) = -(i10 * tx + i11 * ty + i12 * tz);
+        result.get(2, 3) = -(i20 * tx + i21 * ty + i22 * tz);
+
+        return result;
+    }
+
+    template<int Rows, int Columns>
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::rigid_inverse() const requires(Columns == 4 && (Rows == 3 || Rows == 4))
+    {
+        //only valid for an orthonormal rotation plus translation, the rotation's inverse is its transpose
+        Matrix result = identity();
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                result.get(row, column) = get(column, row);
+            }
+        }
+        for (int row = 0; row < 3; ++row)
+        {
+            result.get(row, 3) = -(
+                get(0, row) * get(0, 3) +
+                get(1, row) * get(1, 3) +
+                get(2, row) * get(2, 3));
+        }
+
+        return result;
+    }
+
+    template<int Rows, int Columns>
+    constexpr Matrix<Rows, Columns> Matrix<Rows, Columns>::transpose() const
     {
         Matrix result;
         for (int row = 0; row < Rows; ++row)
@@ -211,7 +467,7 @@ namespace geom
 
     //todo: should be limited to matrices with at least 4 columns and 3 rows
     template<int Rows, int Columns>
-    Vector3 Matrix<Rows, Columns>::translation() const
+    constexpr Vector3 Matrix<Rows, Columns>::translation() const
     {
         return { get(0, 3), get(1, 3), get(2,3) };
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "approx.h"
 #include "constants.h"
 #include <math.h>
 
@@ -14,6 +15,17 @@ namespace geom
     using Matrix44 = Matrix<4, 4>;
     using Matrix34 = Matrix<3, 4>;
 
+    //methods for interpolating rotations, in order of decreasing accuracy and cost
+    //largest angle from a double precision slerp for unit inputs up to a half turn apart:
+    //fast slerp 1.5e-6 radians, corrected nlerp 8e-4 (7e-5 within 1.5 radians), nlerp 0.14 (0.014 within 1.5 radians)
+    enum class RotationInterpolation
+    {
+        Slerp,
+        FastSlerp,
+        CorrectedNlerp,
+        Nlerp
+    };
+
     //struct
 
     struct Quaternion
@@ -23,26 +35,33 @@ namespace geom
         float z;
         float w;
 
-        static Quaternion identity() { return { 0,0,0,1.f }; }
+        static constexpr Quaternion identity() { return { 0,0,0,1.f }; }
         static Quaternion slerp(const Quaternion& q1, const Quaternion& q2, float t);
+        //cheaper alternatives to slerp, all take the shortest arc between the inputs, which are expected to be unit quaternions
+        //fast_slerp uses the polynomial trig in approx.h, corrected_nlerp adjusts t so nlerp follows slerp's constant angular velocity
+        static Quaternion fast_slerp(const Quaternion& q1, const Quaternion& q2, float t);
+        static Quaternion corrected_nlerp(const Quaternion& q1, const Quaternion& q2, float t);
+        static Quaternion nlerp(const Quaternion& q1, const Quaternion& q2, float t);
+        static Quaternion interpolate(const Quaternion& q1, const Quaternion& q2, float t, RotationInterpolation method);
+        static constexpr float dot(const Quaternion& lhs, const Quaternion& rhs);
         static Quaternion from_rotation_matrix(const Matrix44& mat);
 
         Quaternion raised_to_power(float power) const;
         Quaternion normalized() const;
-        Quaternion inverse() const;
-        Vector3 axis() const;
+        constexpr Quaternion inverse() const;
+        constexpr Vector3 axis() const;
         Vector3 axis_normalized() const;
         float angle() const;
-        float mod_squared() const;
+        constexpr float mod_squared() const;
     };
 
     //operators
 
-    bool operator==(const Quaternion& lhs, const Quaternion& rhs);
-    bool operator!=(const Quaternion& lhs, const Quaternion& rhs);
+    constexpr bool operator==(const Quaternion& lhs, const Quaternion& rhs);
+    constexpr bool operator!=(const Quaternion& lhs, const Quaternion& rhs);
 
-    Quaternion operator+(const Quaternion& lhs, const Quaternion& rhs);
-    Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs);
+    constexpr Quaternion operator+(const Quaternion& lhs, const Quaternion& rhs);
+    constexpr Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs);
 }
 
 //deliberately included after declarations to prevent circular dependency
@@ -54,7 +73,7 @@ namespace geom
 {
     //inline operator definitions
 
-    inline bool operator==(const Quaternion& lhs, const Quaternion& rhs)
+    constexpr bool operator==(const Quaternion& lhs, const Quaternion& rhs)
     {
         return
             lhs.x == rhs.x &&
@@ -63,12 +82,12 @@ namespace geom
             lhs.w == rhs.w;
     }
 
-    inline bool operator!=(const Quaternion& lhs, const Quaternion& rhs)
+    constexpr bool operator!=(const Quaternion& lhs, const Quaternion& rhs)
     {
         return !(lhs == rhs);
     }
 
-    inline Quaternion operator+(const Quaternion& lhs, const Quaternion& rhs)
+    constexpr Quaternion operator+(const Quaternion& lhs, const Quaternion& rhs)
     {
         return { 
             lhs.x + rhs.x,
@@ -78,7 +97,7 @@ namespace geom
         };
     }
 
-    inline Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs)
+    constexpr Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs)
     {
         //lhs.x * i * rhs.(xi, yj, zk, w)
         Quaternion qx = {
@@ -112,7 +131,7 @@ namespace geom
         return qx + qy + qz + qw;
     }
 
-    inline Quaternion operator*(const Quaternion& q, float f)
+    constexpr Quaternion operator*(const Quaternion& q, float f)
     {
         return{
             q.x * f,
@@ -178,6 +197,56 @@ namespace geom
         //return result;
     }
 
+    inline Quaternion Quaternion::fast_slerp(const Quaternion& q1, const Quaternion& q2, float t)
+    {
+        float cos_theta = dot(q1, q2);
+        float sign = cos_theta < 0.f ? -1.f : 1.f;
+        float theta = approx::acos(cos_theta * sign);
+
+        //sin(t * theta) / sin(theta) written in terms of sinc so parallel inputs need no special case
+        float inv_sinc_theta = 1.f / approx::sinc(theta);
+        float weight1 = (1.f - t) * approx::sinc((1.f - t) * theta) * inv_sinc_theta;
+        float weight2 = t * approx::sinc(t * theta) * inv_sinc_theta;
+
+        return (q1 * weight1 + q2 * (weight2 * sign)).normalized();
+    }
+
+    inline Quaternion Quaternion::corrected_nlerp(const Quaternion& q1, const Quaternion& q2, float t)
+    {
+        //cubic correction of t fitted against slerp, from http://zeux.io/2015/07/23/approximating-slerp/
+        float d = fabsf(dot(q1, q2));
+        float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+        float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+        float k = a * (t - 0.5f) * (t - 0.5f) + b;
+        return nlerp(q1, q2, t + t * (t - 0.5f) * (t - 1.f) * k);
+    }
+
+    inline Quaternion Quaternion::nlerp(const Quaternion& q1, const Quaternion& q2, float t)
+    {
+        float sign = dot(q1, q2) < 0.f ? -1.f : 1.f;
+        return (q1 * (1.f - t) + q2 * (t * sign)).normalized();
+    }
+
+    inline Quaternion Quaternion::interpolate(const Quaternion& q1, const Quaternion& q2, float t, RotationInterpolation method)
+    {
+        switch (method)
+        {
+        case RotationInterpolation::FastSlerp:
+            return fast_slerp(q1, q2, t);
+        case RotationInterpolation::CorrectedNlerp:
+            return corrected_nlerp(q1, q2, t);
+        case RotationInterpolation::Nlerp:
+            return nlerp(q1, q2, t);
+        default:
+            return slerp(q1, q2, t);
+        }
+    }
+
+    constexpr float Quaternion::dot(const Quaternion& lhs, const Quaternion& rhs)
+    {
+        return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+    }
+
     inline Quaternion Quaternion::from_rotation_matrix(const Matrix44& m)
     {
         //copied from https://d3cw3dd2w32x2b.cloudfront.net/wp-content/uploads/2015/01/matrix-to-quat.pdf
@@ -244,12 +313,12 @@ namespace geom
         return { x * scaling, y * scaling, z * scaling, w * scaling };
     }
 
-    inline Quaternion Quaternion::inverse() const
+    constexpr Quaternion Quaternion::inverse() const
     {
         return { -x, -y, -z, w };
     }
 
-    inline Vector3 Quaternion::axis() const
+    constexpr Vector3 Quaternion::axis() const
     {
         return { x,y,z };
     }
@@ -264,7 +333,7 @@ namespace geom
         return 2.f * acosf(fminf(w, 1.f));
     }
 
-    inline float Quaternion::mod_squared() const
+    constexpr float Quaternion::mod_squared() const
     {
         return x * x + y * y + z * z + w * w;
     }
@@ -0,0 +1,172 @@
+#pragma once
+
+//low level vectorised kernels used by the matrix and wide headers
+//the instruction set is chosen at compile time, define GEOM_NO_SIMD to force the scalar fallback
+
+#if !defined(GEOM_NO_SIMD)
+    #if defined(__AVX__)
+        #define GEOM_SIMD_AVX 1
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define GEOM_SIMD_SSE 1
+    #endif
+#endif
+
+#if defined(GEOM_SIMD_AVX)
+    #include <immintrin.h>
+#elif defined(GEOM_SIMD_SSE)
+    #include <emmintrin.h>
+#endif
+
+#include <math.h>
+#include <type_traits>
+
+namespace geom::simd
+{
+    //name of the instruction set the kernels were compiled for
+    constexpr const char* instruction_set()
+    {
+#if defined(GEOM_SIMD_AVX)
+        return "avx";
+#elif defined(GEOM_SIMD_SSE)
+        return "sse";
+#else
+        return "scalar";
+#endif
+    }
+
+    //all matrix arguments are column major 4x4 arrays of 16 floats aligned to 16 bytes, so 256 bit accesses are unaligned
+    //out may not alias lhs or rhs
+
+    //with sse alone the plain loop is used, compilers vectorise it as well as a hand written sse kernel (see maths_bench)
+    inline void multiply_44(const float* lhs, const float* rhs, float* out)
+    {
+#if defined(GEOM_SIMD_AVX)
+        //each 256 bit register holds two columns of the rhs/result
+        __m256 l0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 0));
+        __m256 l1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 4));
+        __m256 l2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 8));
+        __m256 l3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 12));
+
+        for (int column = 0; column < 4; column += 2)
+        {
+            __m256 r = _mm256_loadu_ps(rhs + column * 4);
+            __m256 result = _mm256_mul_ps(l0, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l1, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l2, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2))));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l3, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+            _mm256_storeu_ps(out + column * 4, result);
+        }
+#else
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                out[row + column * 4] =
+                    lhs[row + 0] * rhs[0 + column * 4] +
+                    lhs[row + 4] * rhs[1 + column * 4] +
+                    lhs[row + 8] * rhs[2 + column * 4] +
+                    lhs[row + 12] * rhs[3 + column * 4];
+            }
+        }
+#endif
+    }
+
+    //register sets used by the wide (structure of arrays) types
+    //each provides the same static interface over a register of width floats
+
+    struct Scalar
+    {
+        using Register = float;
+        static constexpr int width = 1;
+
+        static Register load(const float* source) { return *source; }
+        static void store(float* destination, Register value) { *destination = value; }
+        static Register broadcast(float value) { return value; }
+
+        static Register add(Register lhs, Register rhs) { return lhs + rhs; }
+        static Register sub(Register lhs, Register rhs) { return lhs - rhs; }
+        static Register mul(Register lhs, Register rhs) { return lhs * rhs; }
+        static Register div(Register lhs, Register rhs) { return lhs / rhs; }
+        static Register min(Register lhs, Register rhs) { return fminf(lhs, rhs); }
+        static Register max(Register lhs, Register rhs) { return fmaxf(lhs, rhs); }
+        static Register sqrt(Register value) { return sqrtf(value); }
+        static Register copysign(Register magnitude, Register sign) { return copysignf(magnitude, sign); }
+        static Register round(Register value) { return nearbyintf(value); }
+    };
+
+#if defined(GEOM_SIMD_SSE)
+    struct Sse
+    {
+        using Register = __m128;
+        static constexpr int width = 4;
+
+        static Register load(const float* source) { return _mm_load_ps(source); }
+        static void store(float* destination, Register value) { _mm_store_ps(destination, value); }
+        static Register broadcast(float value) { return _mm_set1_ps(value); }
+
+        static Register add(Register lhs, Register rhs) { return _mm_add_ps(lhs, rhs); }
+        static Register sub(Register lhs, Register rhs) { return _mm_sub_ps(lhs, rhs); }
+        static Register mul(Register lhs, Register rhs) { return _mm_mul_ps(lhs, rhs); }
+        static Register div(Register lhs, Register rhs) { return _mm_div_ps(lhs, rhs); }
+        static Register min(Register lhs, Register rhs) { return _mm_min_ps(lhs, rhs); }
+        static Register max(Register lhs, Register rhs) { return _mm_max_ps(lhs, rhs); }
+        static Register sqrt(Register value) { return _mm_sqrt_ps(value); }
+        static Register copysign(Register magnitude, Register sign)
+        {
+            Register sign_bit = _mm_set1_ps(-0.f);
+            return _mm_or_ps(_mm_andnot_ps(sign_bit, magnitude), _mm_and_ps(sign_bit, sign));
+        }
+        //sse2 has no rounding instruction, the round trip through int32 is exact for |value| < 2^31
+        static Register round(Register value) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(value)); }
+    };
+#endif
+
+#if defined(GEOM_SIMD_AVX)
+    struct Avx
+    {
+        using Register = __m256;
+        static constexpr int width = 8;
+
+        static Register load(const float* source) { return _mm256_load_ps(source); }
+        static void store(float* destination, Register value) { _mm256_store_ps(destination, value); }
+        static Register broadcast(float value) { return _mm256_set1_ps(value); }
+
+        static Register add(Register lhs, Register rhs) { return _mm256_add_ps(lhs, rhs); }
+        static Register sub(Register lhs, Register rhs) { return _mm256_sub_ps(lhs, rhs); }
+        static Register mul(Register lhs, Register rhs) { return _mm256_mul_ps(lhs, rhs); }
+        static Register div(Register lhs, Register rhs) { return _mm256_div_ps(lhs, rhs); }
+        static Register min(Register lhs, Register rhs) { return _mm256_min_ps(lhs, rhs); }
+        static Register max(Register lhs, Register rhs) { return _mm256_max_ps(lhs, rhs); }
+        static Register sqrt(Register value) { return _mm256_sqrt_ps(value); }
+        static Register copysign(Register magnitude, Register sign)
+        {
+            Register sign_bit = _mm256_set1_ps(-0.f);
+            return _mm256_or_ps(_mm256_andnot_ps(sign_bit, magnitude), _mm256_and_ps(sign_bit, sign));
+        }
+        static Register round(Register value) { return _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    };
+#endif
+
+    //widest register set that evenly divides Width
+    template<int Width>
+    struct RegisterSetFor
+    {
+#if defined(GEOM_SIMD_AVX)
+        using Type = std::conditional_t<Width % 8 == 0, Avx, std::conditional_t<Width % 4 == 0, Sse, Scalar>>;
+#elif defined(GEOM_SIMD_SSE)
+        using Type = std::conditional_t<Width % 4 == 0, Sse, Scalar>;
+#else
+        using Type = Scalar;
+#endif
+    };
+    template<int Width>
+    using RegisterSet = typename RegisterSetFor<Width>::Type;
+
+    //number of lanes that fill the widest available register
+#if defined(GEOM_SIMD_AVX)
+    constexpr int native_width = 8;
+#else
+    constexpr int native_width = 4;
+#endif
+}
\ No newline at end of file
@@ -23,42 +23,42 @@ namespace geom
         float z;
 
         //useful default values
-        static Vector3 zero() { return { 0.f,0.f,0.f }; }
-        static Vector3 one() { return { 1.f,1.f,1.f }; }
-        static Vector3 unit_x() { return { 1.f,0.f,0.f }; }
-        static Vector3 unit_y() { return { 0.f,1.f,0.f }; }
-        static Vector3 unit_z() { return { 0.f,0.f,1.f }; }
+        static constexpr Vector3 zero() { return { 0.f,0.f,0.f }; }
+        static constexpr Vector3 one() { return { 1.f,1.f,1.f }; }
+        static constexpr Vector3 unit_x() { return { 1.f,0.f,0.f }; }
+        static constexpr Vector3 unit_y() { return { 0.f,1.f,0.f }; }
+        static constexpr Vector3 unit_z() { return { 0.f,0.f,1.f }; }
 
         //operations
         //+-*/ operations are defined as non-member functions
-        static float dot(const Vector3&, const Vector3&);
-        static Vector3 cross(const Vector3&, const Vector3&);
-        static Vector3 interpolate(const Vector3&, const Vector3&, float t);
+        static constexpr float dot(const Vector3&, const Vector3&);
+        static constexpr Vector3 cross(const Vector3&, const Vector3&);
+        static constexpr Vector3 interpolate(const Vector3&, const Vector3&, float t);
 
-        float magnitude_squared() const;
+        constexpr float magnitude_squared() const;
         float magnitude() const;
         Vector3 normalized() const;
     };
 
     //operators
 
-    bool operator==(const Vector3& lhs, const Vector3& rhs);
-    bool operator!=(const Vector3& lhs, const Vector3& rhs);
+    constexpr bool operator==(const Vector3& lhs, const Vector3& rhs);
+    constexpr bool operator!=(const Vector3& lhs, const Vector3& rhs);
 
-    Vector3 operator-(const Vector3& value);
+    constexpr Vector3 operator-(const Vector3& value);
 
-    Vector3 operator+(const Vector3& lhs, const Vector3& rhs);
-    Vector3& operator+=(Vector3& lhs, const Vector3& rhs);
+    constexpr Vector3 operator+(const Vector3& lhs, const Vector3& rhs);
+    constexpr Vector3& operator+=(Vector3& lhs, const Vector3& rhs);
 
-    Vector3 operator-(const Vector3& lhs, const Vector3& rhs);
-    Vector3& operator-=(Vector3& lhs, const Vector3& rhs);
+    constexpr Vector3 operator-(const Vector3& lhs, const Vector3& rhs);
+    constexpr Vector3& operator-=(Vector3& lhs, const Vector3& rhs);
 
-    Vector3 operator*(const Vector3& lhs, float rhs);
-    Vector3 operator*(float lhs, const Vector3& rhs);
-    Vector3& operator*=(Vector3& lhs, float rhs);
+    constexpr Vector3 operator*(const Vector3& lhs, float rhs);
+    constexpr Vector3 operator*(float lhs, const Vector3& rhs);
+    constexpr Vector3& operator*=(Vector3& lhs, float rhs);
 
-    Vector3 operator/(const Vector3& lhs, float rhs);
-    Vector3& operator/=(Vector3& lhs, float rhs);
+    constexpr Vector3 operator/(const Vector3& lhs, float rhs);
+    constexpr Vector3& operator/=(Vector3& lhs, float rhs);
 }
 
 //deliberately included after declarations to prevent circular dependency
@@ -70,7 +70,7 @@ namespace geom
 {
     //inline operator definitions
 
-    inline bool operator==(const Vector3& lhs, const Vector3& rhs)
+    constexpr bool operator==(const Vector3& lhs, const Vector3& rhs)
     {
         return
             lhs.x == rhs.x &&
@@ -78,12 +78,12 @@ namespace geom
             lhs.z == rhs.z;
     }
 
-    inline bool operator!=(const Vector3& lhs, const Vector3& rhs)
+    constexpr bool operator!=(const Vector3& lhs, const Vector3& rhs)
     {
         return !(lhs == rhs);
     }
 
-    inline Vector3 operator-(const Vector3& value)
+    constexpr Vector3 operator-(const Vector3& value)
     {
         return {
             -value.x,
@@ -92,7 +92,7 @@ namespace geom
         };
     }
 
-    inline Vector3 operator+(const Vector3& lhs, const Vector3& rhs)
+    constexpr Vector3 operator+(const Vector3& lhs, const Vector3& rhs)
     {
         return {
             lhs.x + rhs.x,
@@ -100,12 +100,12 @@ namespace geom
             lhs.z + rhs.z
         };
     }
-    inline Vector3& operator+=(Vector3& lhs, const Vector3& rhs)
+    constexpr Vector3& operator+=(Vector3& lhs, const Vector3& rhs)
     {
         return lhs = lhs + rhs;
     }
 
-    inline Vector3 operator-(const Vector3& lhs, const Vector3& rhs)
+    constexpr Vector3 operator-(const Vector3& lhs, const Vector3& rhs)
     {
         return {
             lhs.x - rhs.x,
@@ -113,12 +113,12 @@ namespace geom
             lhs.z - rhs.z
         };
     }
-    inline Vector3& operator-=(Vector3& lhs, const Vector3& rhs)
+    constexpr Vector3& operator-=(Vector3& lhs, const Vector3& rhs)
     {
         return lhs = lhs - rhs;
     }
 
-    inline Vector3 operator*(const Vector3& lhs, float rhs)
+    constexpr Vector3 operator*(const Vector3& lhs, float rhs)
     {
         return {
             lhs.x * rhs,
@@ -126,7 +126,7 @@ namespace geom
             lhs.z * rhs
         };
     }
-    inline Vector3 operator*(float lhs, const Vector3& rhs)
+    constexpr Vector3 operator*(float lhs, const Vector3& rhs)
     {
         return {
             rhs.x * lhs,
@@ -134,12 +134,12 @@ namespace geom
             rhs.z * lhs
         };
     }
-    inline Vector3& operator*=(Vector3& lhs, float rhs)
+    constexpr Vector3& operator*=(Vector3& lhs, float rhs)
     {
         return lhs = lhs * rhs;
     }
 
-    inline Vector3 operator/(const Vector3& lhs, float rhs)
+    constexpr Vector3 operator/(const Vector3& lhs, float rhs)
     {
         _ASSERT(rhs != 0.f);
 
@@ -149,14 +149,14 @@ namespace geom
             lhs.z / rhs
         };
     }
-    inline Vector3& operator/=(Vector3& lhs, float rhs)
+    constexpr Vector3& operator/=(Vector3& lhs, float rhs)
     {
         return lhs = lhs / rhs;
     }
 
     //inline member definitions
 
-    inline float Vector3::dot(const Vector3& lhs, const Vector3& rhs)
+    constexpr float Vector3::dot(const Vector3& lhs, const Vector3& rhs)
     {
         return
             lhs.x * rhs.x +
@@ -164,7 +164,7 @@ namespace geom
             lhs.z * rhs.z;
     }
 
-    inline Vector3 Vector3::cross(const Vector3& lhs, const Vector3& rhs)
+    constexpr Vector3 Vector3::cross(const Vector3& lhs, const Vector3& rhs)
     {
         return {
             lhs.y * rhs.z - lhs.z * rhs.y,
@@ -173,7 +173,7 @@ namespace geom
         };
     }
 
-    inline Vector3 Vector3::interpolate(const Vector3& v1, const Vector3& v2, float t)
+    constexpr Vector3 Vector3::interpolate(const Vector3& v1, const Vector3& v2, float t)
     {
         return {
             std::lerp(v1.x, v2.x, t),
@@ -182,7 +182,7 @@ namespace geom
         };
     }
 
-    inline float Vector3::magnitude_squared() const
+    constexpr float Vector3::magnitude_squared() const
     {
         return x * x + y * y + z * z;
     }
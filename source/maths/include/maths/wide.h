@@ -0,0 +1,687 @@
+#pragma once
+
+#include "approx.h"
+#include "quaternion.h"
+#include "simd.h"
+#include "vector3.h"
+
+//structure of arrays versions of the maths types
+//each wide type holds Width elements with one element per lane, so every operation processes Width values at once
+
+namespace geom
+{
+    //structs
+
+    template<int Width>
+    struct alignas(Width * sizeof(float)) FloatxN
+    {
+        static_assert(Width == 4 || Width == 8, "Wide types support 4 or 8 lanes.");
+
+        float lanes[Width];
+
+        static FloatxN broadcast(float value);
+        static FloatxN sqrt(const FloatxN& value);
+        static FloatxN min(const FloatxN& lhs, const FloatxN& rhs);
+        static FloatxN max(const FloatxN& lhs, const FloatxN& rhs);
+        static FloatxN copysign(const FloatxN& magnitude, const FloatxN& sign);
+        //to the nearest integer, ties to even
+        static FloatxN round(const FloatxN& value);
+        static FloatxN interpolate(const FloatxN& v1, const FloatxN& v2, const FloatxN& t);
+    };
+
+    template<int Width>
+    struct Vector3xN
+    {
+        FloatxN<Width> x;
+        FloatxN<Width> y;
+        FloatxN<Width> z;
+
+        //conversion from/to arrays of structs, lanes past count are padded with zero on load and ignored on store
+        static Vector3xN broadcast(const Vector3& value);
+        static Vector3xN load(const Vector3* source, int count = Width);
+        template<typename T>
+        static Vector3xN load(const T* source, Vector3 T::* member, int count = Width);
+        void store(Vector3* destination, int count = Width) const;
+        template<typename T>
+        void store(T* destination, Vector3 T::* member, int count = Width) const;
+        //writes a single lane, for gathering elements that aren't contiguous
+        void set_lane(int lane, const Vector3& value);
+
+        static FloatxN<Width> dot(const Vector3xN&, const Vector3xN&);
+        static Vector3xN cross(const Vector3xN&, const Vector3xN&);
+        static Vector3xN interpolate(const Vector3xN&, const Vector3xN&, const FloatxN<Width>& t);
+
+        FloatxN<Width> magnitude_squared() const;
+        Vector3xN normalized() const;
+    };
+
+    template<int Width>
+    struct QuaternionxN
+    {
+        FloatxN<Width> x;
+        FloatxN<Width> y;
+        FloatxN<Width> z;
+        FloatxN<Width> w;
+
+        //conversion from/to arrays of structs, lanes past count are padded with identity on load and ignored on store
+        static QuaternionxN broadcast(const Quaternion& value);
+        static QuaternionxN load(const Quaternion* source, int count = Width);
+        template<typename T>
+        static QuaternionxN load(const T* source, Quaternion T::* member, int count = Width);
+        void store(Quaternion* destination, int count = Width) const;
+        template<typename T>
+        void store(T* destination, Quaternion T::* member, int count = Width) const;
+        //writes a single lane, for gathering elements that aren't contiguous
+        void set_lane(int lane, const Quaternion& value);
+
+        //all interpolations take the shortest arc between the inputs, which are expected to be unit quaternions
+        //see the scalar quaternion for the differences between them
+        static QuaternionxN nlerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t);
+        static QuaternionxN corrected_nlerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t);
+        static QuaternionxN slerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t);
+        static QuaternionxN fast_slerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t);
+        static QuaternionxN interpolate(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t, RotationInterpolation method);
+        static FloatxN<Width> dot(const QuaternionxN&, const QuaternionxN&);
+
+        QuaternionxN normalized() const;
+        QuaternionxN inverse() const;
+        FloatxN<Width> mod_squared() const;
+    };
+
+    using Floatx4 = FloatxN<4>;
+    using Floatx8 = FloatxN<8>;
+    using Vector3x4 = Vector3xN<4>;
+    using Vector3x8 = Vector3xN<8>;
+    using Quaternionx4 = QuaternionxN<4>;
+    using Quaternionx8 = QuaternionxN<8>;
+
+    //operators
+
+    template<int Width>
+    FloatxN<Width> operator-(const FloatxN<Width>& value);
+    template<int Width>
+    FloatxN<Width> operator+(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs);
+    template<int Width>
+    FloatxN<Width> operator-(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs);
+    template<int Width>
+    FloatxN<Width> operator*(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs);
+    template<int Width>
+    FloatxN<Width> operator/(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs);
+
+    template<int Width>
+    Vector3xN<Width> operator+(const Vector3xN<Width>& lhs, const Vector3xN<Width>& rhs);
+    template<int Width>
+    Vector3xN<Width> operator-(const Vector3xN<Width>& lhs, const Vector3xN<Width>& rhs);
+    template<int Width>
+    Vector3xN<Width> operator*(const Vector3xN<Width>& lhs, const FloatxN<Width>& rhs);
+
+    template<int Width>
+    QuaternionxN<Width> operator+(const QuaternionxN<Width>& lhs, const QuaternionxN<Width>& rhs);
+    template<int Width>
+    QuaternionxN<Width> operator*(const QuaternionxN<Width>& lhs, const FloatxN<Width>& rhs);
+    template<int Width>
+    QuaternionxN<Width> operator*(const QuaternionxN<Width>& lhs, const QuaternionxN<Width>& rhs);
+    //rotates each vector by the quaternion in the same lane
+    template<int Width>
+    Vector3xN<Width> operator*(const QuaternionxN<Width>& q, const Vector3xN<Width>& vec);
+}
+
+//wide versions of the approximations, with the same error bounds as the scalar functions
+namespace geom::approx
+{
+    template<int Width>
+    FloatxN<Width> sinc(const FloatxN<Width>& x);
+    template<int Width>
+    FloatxN<Width> sin(const FloatxN<Width>& x);
+    template<int Width>
+    FloatxN<Width> cos(const FloatxN<Width>& x);
+    template<int Width>
+    FloatxN<Width> acos(const FloatxN<Width>& x);
+}
+
+//inline definitions
+namespace geom
+{
+    namespace detail
+    {
+        //applies op to each register sized block of lanes, op receives the register set and the loaded registers
+        template<int Width, typename Op>
+        FloatxN<Width> lanewise(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs, Op op)
+        {
+            using Set = simd::RegisterSet<Width>;
+
+            FloatxN<Width> result;
+            for (int i = 0; i < Width; i += Set::width)
+            {
+                Set::store(result.lanes + i, op(Set{}, Set::load(lhs.lanes + i), Set::load(rhs.lanes + i)));
+            }
+            return result;
+        }
+    }
+
+    //inline operator definitions
+
+    template<int Width>
+    FloatxN<Width> operator-(const FloatxN<Width>& value)
+    {
+        return FloatxN<Width>::broadcast(0.f) - value;
+    }
+    template<int Width>
+    FloatxN<Width> operator+(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.add(l, r); });
+    }
+    template<int Width>
+    FloatxN<Width> operator-(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.sub(l, r); });
+    }
+    template<int Width>
+    FloatxN<Width> operator*(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.mul(l, r); });
+    }
+    template<int Width>
+    FloatxN<Width> operator/(const FloatxN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.div(l, r); });
+    }
+
+    template<int Width>
+    Vector3xN<Width> operator+(const Vector3xN<Width>& lhs, const Vector3xN<Width>& rhs)
+    {
+        return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z };
+    }
+    template<int Width>
+    Vector3xN<Width> operator-(const Vector3xN<Width>& lhs, const Vector3xN<Width>& rhs)
+    {
+        return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z };
+    }
+    template<int Width>
+    Vector3xN<Width> operator*(const Vector3xN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs };
+    }
+
+    template<int Width>
+    QuaternionxN<Width> operator+(const QuaternionxN<Width>& lhs, const QuaternionxN<Width>& rhs)
+    {
+        return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w };
+    }
+    template<int Width>
+    QuaternionxN<Width> operator*(const QuaternionxN<Width>& lhs, const FloatxN<Width>& rhs)
+    {
+        return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs };
+    }
+    template<int Width>
+    QuaternionxN<Width> operator*(const QuaternionxN<Width>& lhs, const QuaternionxN<Width>& rhs)
+    {
+        //same product as the scalar quaternion, expanded so no temporary quaternions are needed
+        return {
+            lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+            lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+            lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+            lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z
+        };
+    }
+    template<int Width>
+    Vector3xN<Width> operator*(const QuaternionxN<Width>& q, const Vector3xN<Width>& vec)
+    {
+        //v + w * t + axis x t, where t = 2 * axis x v, equivalent to q * v * q^-1 for unit quaternions
+        Vector3xN<Width> axis = { q.x, q.y, q.z };
+        Vector3xN<Width> t = Vector3xN<Width>::cross(axis, vec) * FloatxN<Width>::broadcast(2.f);
+        return vec + t * q.w + Vector3xN<Width>::cross(axis, t);
+    }
+
+    //inline member definitions
+
+    //FloatxN
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::broadcast(float value)
+    {
+        FloatxN result;
+        for (int i = 0; i < Width; ++i)
+        {
+            result.lanes[i] = value;
+        }
+        return result;
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::sqrt(const FloatxN& value)
+    {
+        return detail::lanewise(value, value, [](auto set, auto v, auto) { return set.sqrt(v); });
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::min(const FloatxN& lhs, const FloatxN& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.min(l, r); });
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::max(const FloatxN& lhs, const FloatxN& rhs)
+    {
+        return detail::lanewise(lhs, rhs, [](auto set, auto l, auto r) { return set.max(l, r); });
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::copysign(const FloatxN& magnitude, const FloatxN& sign)
+    {
+        return detail::lanewise(magnitude, sign, [](auto set, auto m, auto s) { return set.copysign(m, s); });
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::round(const FloatxN& value)
+    {
+        return detail::lanewise(value, value, [](auto set, auto v, auto) { return set.round(v); });
+    }
+
+    template<int Width>
+    FloatxN<Width> FloatxN<Width>::interpolate(const FloatxN& v1, const FloatxN& v2, const FloatxN& t)
+    {
+        return v1 + (v2 - v1) * t;
+    }
+
+    //Vector3xN
+
+    template<int Width>
+    Vector3xN<Width> Vector3xN<Width>::broadcast(const Vector3& value)
+    {
+        return { FloatxN<Width>::broadcast(value.x), FloatxN<Width>::broadcast(value.y), FloatxN<Width>::broadcast(value.z) };
+    }
+
+    template<int Width>
+    Vector3xN<Width> Vector3xN<Width>::load(const Vector3* source, int count)
+    {
+        _ASSERT(count <= Width);
+
+        Vector3xN result = broadcast(Vector3::zero());
+        for (int i = 0; i < count; ++i)
+        {
+            result.x.lanes[i] = source[i].x;
+            result.y.lanes[i] = source[i].y;
+            result.z.lanes[i] = source[i].z;
+        }
+        return result;
+    }
+
+    template<int Width>
+    template<typename T>
+    Vector3xN<Width> Vector3xN<Width>::load(const T* source, Vector3 T::* member, int count)
+    {
+        _ASSERT(count <= Width);
+
+        Vector3xN result = broadcast(Vector3::zero());
+        for (int i = 0; i < count; ++i)
+        {
+            const Vector3& value = source[i].*member;
+            result.x.lanes[i] = value.x;
+            result.y.lanes[i] = value.y;
+            result.z.lanes[i] = value.z;
+        }
+        return result;
+    }
+
+    template<int Width>
+    void Vector3xN<Width>::store(Vector3* destination, int count) const
+    {
+        _ASSERT(count <= Width);
+
+        for (int i = 0; i < count; ++i)
+        {
+            destination[i] = { x.lanes[i], y.lanes[i], z.lanes[i] };
+        }
+    }
+
+    template<int Width>
+    template<typename T>
+    void Vector3xN<Width>::store(T* destination, Vector3 T::* member, int count) const
+    {
+        _ASSERT(count <= Width);
+
+        for (int i = 0; i < count; ++i)
+        {
+            destination[i].*member = { x.lanes[i], y.lanes[i], z.lanes[i] };
+        }
+    }
+
+    template<int Width>
+    FloatxN<Width> Vector3xN<Width>::dot(const Vector3xN& lhs, const Vector3xN& rhs)
+    {
+        return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+    }
+
+    template<int Width>
+    Vector3xN<Width> Vector3xN<Width>::cross(const Vector3xN& lhs, const Vector3xN& rhs)
+    {
+        return {
+            lhs.y * rhs.z - lhs.z * rhs.y,
+            lhs.z * rhs.x - lhs.x * rhs.z,
+            lhs.x * rhs.y - lhs.y * rhs.x
+        };
+    }
+
+    template<int Width>
+    Vector3xN<Width> Vector3xN<Width>::interpolate(const Vector3xN& v1, const Vector3xN& v2, const FloatxN<Width>& t)
+    {
+        return v1 + (v2 - v1) * t;
+    }
+
+    template<int Width>
+    FloatxN<Width> Vector3xN<Width>::magnitude_squared() const
+    {
+        return dot(*this, *this);
+    }
+
+    template<int Width>
+    Vector3xN<Width> Vector3xN<Width>::normalized() const
+    {
+        //zero length lanes stay zero, as with Vector3::normalized
+        FloatxN<Width> magnitude = FloatxN<Width>::max(FloatxN<Width>::sqrt(magnitude_squared()), FloatxN<Width>::broadcast(1e-30f));
+        return *this * (FloatxN<Width>::broadcast(1.f) / magnitude);
+    }
+
+    template<int Width>
+    void Vector3xN<Width>::set_lane(int lane, const Vector3& value)
+    {
+        _ASSERT(lane < Width);
+
+        x.lanes[lane] = value.x;
+        y.lanes[lane] = value.y;
+        z.lanes[lane] = value.z;
+    }
+
+    //QuaternionxN
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::broadcast(const Quaternion& value)
+    {
+        return {
+            FloatxN<Width>::broadcast(value.x),
+            FloatxN<Width>::broadcast(value.y),
+            FloatxN<Width>::broadcast(value.z),
+            FloatxN<Width>::broadcast(value.w)
+        };
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::load(const Quaternion* source, int count)
+    {
+        _ASSERT(count <= Width);
+
+        QuaternionxN result = broadcast(Quaternion::identity());
+        int i = 0;
+
+#if defined(GEOM_SIMD_SSE)
+        //a quaternion fills an sse register, so full blocks of 4 are a 4x4 transpose
+        for (; i + 4 <= count; i += 4)
+        {
+            const float* block = &source[i].x;
+            __m128 q0 = _mm_loadu_ps(block + 0);
+            __m128 q1 = _mm_loadu_ps(block + 4);
+            __m128 q2 = _mm_loadu_ps(block + 8);
+            __m128 q3 = _mm_loadu_ps(block + 12);
+            _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+            _mm_store_ps(result.x.lanes + i, q0);
+            _mm_store_ps(result.y.lanes + i, q1);
+            _mm_store_ps(result.z.lanes + i, q2);
+            _mm_store_ps(result.w.lanes + i, q3);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            result.x.lanes[i] = source[i].x;
+            result.y.lanes[i] = source[i].y;
+            result.z.lanes[i] = source[i].z;
+            result.w.lanes[i] = source[i].w;
+        }
+        return result;
+    }
+
+    template<int Width>
+    template<typename T>
+    QuaternionxN<Width> QuaternionxN<Width>::load(const T* source, Quaternion T::* member, int count)
+    {
+        _ASSERT(count <= Width);
+
+        QuaternionxN result = broadcast(Quaternion::identity());
+        for (int i = 0; i < count; ++i)
+        {
+            const Quaternion& value = source[i].*member;
+            result.x.lanes[i] = value.x;
+            result.y.lanes[i] = value.y;
+            result.z.lanes[i] = value.z;
+            result.w.lanes[i] = value.w;
+        }
+        return result;
+    }
+
+    template<int Width>
+    void QuaternionxN<Width>::store(Quaternion* destination, int count) const
+    {
+        _ASSERT(count <= Width);
+
+        int i = 0;
+
+#if defined(GEOM_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 q0 = _mm_load_ps(x.lanes + i);
+            __m128 q1 = _mm_load_ps(y.lanes + i);
+            __m128 q2 = _mm_load_ps(z.lanes + i);
+            __m128 q3 = _mm_load_ps(w.lanes + i);
+            _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+            float* block = &destination[i].x;
+            _mm_storeu_ps(block + 0, q0);
+            _mm_storeu_ps(block + 4, q1);
+            _mm_storeu_ps(block + 8, q2);
+            _mm_storeu_ps(block + 12, q3);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            destination[i] = { x.lanes[i], y.lanes[i], z.lanes[i], w.lanes[i] };
+        }
+    }
+
+    template<int Width>
+    template<typename T>
+    void QuaternionxN<Width>::store(T* destination, Quaternion T::* member, int count) const
+    {
+        _ASSERT(count <= Width);
+
+        for (int i = 0; i < count; ++i)
+        {
+            destination[i].*member = { x.lanes[i], y.lanes[i], z.lanes[i], w.lanes[i] };
+        }
+    }
+
+    template<int Width>
+    void QuaternionxN<Width>::set_lane(int lane, const Quaternion& value)
+    {
+        _ASSERT(lane < Width);
+
+        x.lanes[lane] = value.x;
+        y.lanes[lane] = value.y;
+        z.lanes[lane] = value.z;
+        w.lanes[lane] = value.w;
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::nlerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t)
+    {
+        //flip q2 where needed so every lane interpolates along the shortest arc
+        FloatxN<Width> sign = FloatxN<Width>::copysign(FloatxN<Width>::broadcast(1.f), dot(q1, q2));
+        QuaternionxN<Width> q2_near = q2 * sign;
+
+        FloatxN<Width> t1 = FloatxN<Width>::broadcast(1.f) - t;
+        return (q1 * t1 + q2_near * t).normalized();
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::corrected_nlerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t)
+    {
+        using Float = FloatxN<Width>;
+
+        Float d = Float::copysign(dot(q1, q2), Float::broadcast(1.f));
+        Float a = Float::broadcast(1.0904f) + d * (Float::broadcast(-3.2452f) + d * (Float::broadcast(3.55645f) - d * Float::broadcast(1.43519f)));
+        Float b = Float::broadcast(0.848013f) + d * (Float::broadcast(-1.06021f) + d * Float::broadcast(0.215638f));
+        Float t_centred = t - Float::broadcast(0.5f);
+        Float k = a * t_centred * t_centred + b;
+        return nlerp(q1, q2, t + t * t_centred * (t - Float::broadcast(1.f)) * k);
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::slerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t)
+    {
+        FloatxN<Width> cos_theta = dot(q1, q2);
+        FloatxN<Width> sign = FloatxN<Width>::copysign(FloatxN<Width>::broadcast(1.f), cos_theta);
+        cos_theta = cos_theta * sign;
+
+        //the trig is evaluated per lane, lanes that are almost parallel fall back to linear weights
+        FloatxN<Width> weight1;
+        FloatxN<Width> weight2;
+        for (int i = 0; i < Width; ++i)
+        {
+            float c = cos_theta.lanes[i];
+            float lane_t = t.lanes[i];
+            if (c > 0.9995f)
+            {
+                weight1.lanes[i] = 1.f - lane_t;
+                weight2.lanes[i] = lane_t;
+            }
+            else
+            {
+                float theta = acosf(c);
+                float inv_sin_theta = 1.f / sqrtf(1.f - c * c);
+                weight1.lanes[i] = sinf((1.f - lane_t) * theta) * inv_sin_theta;
+                weight2.lanes[i] = sinf(lane_t * theta) * inv_sin_theta;
+            }
+        }
+
+        return (q1 * weight1 + q2 * (weight2 * sign)).normalized();
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::fast_slerp(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t)
+    {
+        using Float = FloatxN<Width>;
+
+        Float cos_theta = dot(q1, q2);
+        Float sign = Float::copysign(Float::broadcast(1.f), cos_theta);
+        Float theta = approx::acos(cos_theta * sign);
+
+        //unlike slerp every lane takes the same path, the sinc form needs no special case for parallel inputs
+        Float t1 = Float::broadcast(1.f) - t;
+        Float inv_sinc_theta = Float::broadcast(1.f) / approx::sinc(theta);
+        Float weight1 = t1 * approx::sinc(t1 * theta) * inv_sinc_theta;
+        Float weight2 = t * approx::sinc(t * theta) * inv_sinc_theta;
+
+        return (q1 * weight1 + q2 * (weight2 * sign)).normalized();
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::interpolate(const QuaternionxN& q1, const QuaternionxN& q2, const FloatxN<Width>& t, RotationInterpolation method)
+    {
+        switch (method)
+        {
+        case RotationInterpolation::FastSlerp:
+            return fast_slerp(q1, q2, t);
+        case RotationInterpolation::CorrectedNlerp:
+            return corrected_nlerp(q1, q2, t);
+        case RotationInterpolation::Nlerp:
+            return nlerp(q1, q2, t);
+        default:
+            return slerp(q1, q2, t);
+        }
+    }
+
+    template<int Width>
+    FloatxN<Width> QuaternionxN<Width>::dot(const QuaternionxN& lhs, const QuaternionxN& rhs)
+    {
+        return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::normalized() const
+    {
+        return *this * (FloatxN<Width>::broadcast(1.f) / FloatxN<Width>::sqrt(mod_squared()));
+    }
+
+    template<int Width>
+    QuaternionxN<Width> QuaternionxN<Width>::inverse() const
+    {
+        return { -x, -y, -z, w };
+    }
+
+    template<int Width>
+    FloatxN<Width> QuaternionxN<Width>::mod_squared() const
+    {
+        return dot(*this, *this);
+    }
+}
+
+//inline approximation definitions
+namespace geom::approx
+{
+    template<int Width>
+    FloatxN<Width> sinc(const FloatxN<Width>& x)
+    {
+        using Float = FloatxN<Width>;
+
+        Float x2 = x * x;
+        return Float::broadcast(detail::g_sin_1) + x2 * (Float::broadcast(detail::g_sin_3) + x2 * (Float::broadcast(detail::g_sin_5) + x2 * Float::broadcast(detail::g_sin_7)));
+    }
+
+    namespace detail
+    {
+        //sin(x + offset * pi) for offset 0 or 0.5, using the same reduction as the scalar sin and cos
+        //the parity of k is found from the fractional part of k / 2
+        template<int Width>
+        FloatxN<Width> sin_offset(const FloatxN<Width>& x, float offset)
+        {
+            using Float = FloatxN<Width>;
+
+            Float k = Float::round(x * Float::broadcast(1.f / PI) + Float::broadcast(offset));
+            Float r = (x - k * Float::broadcast(g_pi_high)) - k * Float::broadcast(g_pi_low) + Float::broadcast(offset * PI);
+            Float half_k = k * Float::broadcast(0.5f);
+            Float odd = Float::copysign(half_k - Float::round(half_k), Float::broadcast(1.f));
+            Float sign = Float::broadcast(1.f) - odd * Float::broadcast(4.f);
+            return r * sinc(r) * sign;
+        }
+    }
+
+    template<int Width>
+    FloatxN<Width> sin(const FloatxN<Width>& x)
+    {
+        return detail::sin_offset(x, 0.f);
+    }
+
+    template<int Width>
+    FloatxN<Width> cos(const FloatxN<Width>& x)
+    {
+        return detail::sin_offset(x, 0.5f);
+    }
+
+    template<int Width>
+    FloatxN<Width> acos(const FloatxN<Width>& x)
+    {
+        using Float = FloatxN<Width>;
+
+        Float a = Float::min(Float::copysign(x, Float::broadcast(1.f)), Float::broadcast(1.f));
+        Float polynomial = Float::broadcast(detail::g_acos_coefficients[7]);
+        for (int i = 6; i >= 0; --i)
+        {
+            polynomial = polynomial * a + Float::broadcast(detail::g_acos_coefficients[i]);
+        }
+        Float result = Float::sqrt(Float::broadcast(1.f) - a) * polynomial;
+
+        //blend towards pi - result in negative lanes, negative is 1 there and 0 elsewhere
+        Float negative = (Float::broadcast(1.f) - Float::copysign(Float::broadcast(1.f), x)) * Float::broadcast(0.5f);
+        return result + negative * (Float::broadcast(PI) - result - result);
+    }
+}
\ No newline at end of file
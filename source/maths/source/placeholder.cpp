@@ -1 +0,0 @@
-//Empty cpp file to ensure a .lib file is generated
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "maths/geometry.h"
+
+//compile time checks that the constexpr maths evaluates as expected
+//values are chosen so that every intermediate result is exact in floating point
+
+namespace geom
+{
+    namespace
+    {
+        template<int Rows, int Columns>
+        constexpr bool equal(const Matrix<Rows, Columns>& lhs, const Matrix<Rows, Columns>& rhs)
+        {
+            for (int i = 0; i < Rows * Columns; ++i)
+            {
+                if (lhs.values[i] != rhs.values[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr Matrix44 g_translation = create_translation_matrix_44({ 1.f, 2.f, 3.f });
+        constexpr Matrix44 g_scale = create_scale_matrix_44({ 2.f, 4.f, 0.5f });
+        //half turn about z
+        constexpr Quaternion g_rotation = { 0.f, 0.f, 1.f, 0.f };
+        constexpr Matrix44 g_rotation_matrix = create_transform_matrix_44(Vector3::zero(), g_rotation);
+
+        constexpr Matrix<3, 3> g_matrix_33 = { 2.f, 0.f, 1.f, 1.f, 3.f, 0.f, 0.f, 1.f, 4.f };
+    }
+
+    //vectors and quaternions
+    static_assert(Vector3::dot(Vector3::unit_x(), Vector3::unit_y()) == 0.f);
+    static_assert(Vector3::cross(Vector3::unit_x(), Vector3::unit_y()) == Vector3::unit_z());
+    static_assert(Vector3::interpolate(Vector3::zero(), { 2.f, 4.f, 8.f }, 0.5f) == Vector3{ 1.f, 2.f, 4.f });
+    static_assert(Quaternion::identity() * Quaternion{ 1.f, 2.f, 3.f, 4.f } == Quaternion{ 1.f, 2.f, 3.f, 4.f });
+    static_assert(g_rotation * Vector3::unit_x() == -Vector3::unit_x());
+    static_assert(g_rotation * g_rotation.inverse() == Quaternion::identity());
+
+    //small matrix specialisations
+    static_assert(Matrix44::identity().determinant() == 1.f);
+    static_assert(g_scale.determinant() == 4.f);
+    static_assert(g_matrix_33.determinant() == 25.f);
+    static_assert(equal(g_matrix_33 * Matrix<3, 3>::identity(), g_matrix_33));
+    static_assert(equal(Matrix<2, 2>{ 1.f, 2.f, 3.f, 4.f }.transpose(), Matrix<2, 2>{ 1.f, 3.f, 2.f, 4.f }));
+    static_assert(Matrix<2, 2>{ 1.f, 2.f, 3.f, 4.f }.determinant() == -2.f);
+    static_assert(Matrix<5, 5>::identity().determinant() == 1.f);
+
+    //products and inverses
+    static_assert(equal(g_translation * g_translation, create_translation_matrix_44({ 2.f, 4.f, 6.f })));
+    static_assert(equal(create_translation_matrix_34({ 1.f, 2.f, 3.f }) * create_translation_matrix_34({ 1.f, 2.f, 3.f }), create_translation_matrix_34({ 2.f, 4.f, 6.f })));
+    static_assert(equal(g_translation.inverse(), create_translation_matrix_44({ -1.f, -2.f, -3.f })));
+    static_assert(equal(g_translation.rigid_inverse(), create_translation_matrix_44({ -1.f, -2.f, -3.f })));
+    static_assert(equal(g_scale.affine_inverse(), create_scale_matrix_44({ 0.5f, 0.25f, 2.f })));
+    static_assert(equal(g_scale.inverse(), g_scale.inverse_generic()));
+    static_assert(equal((g_translation * g_scale).inverse() * (g_translation * g_scale), Matrix44::identity()));
+    static_assert(equal(create_matrix_44_from_affine(create_transform_matrix_34({ 1.f, 2.f, 3.f }, Quaternion::identity())), g_translation));
+
+    //approximations, within their documented error bounds
+    static_assert(approx::sin(0.f) == 0.f);
+    static_assert(approx::sin(0.5f * PI) > 1.f - 1e-6f && approx::sin(0.5f * PI) < 1.f + 1e-6f);
+    static_assert(approx::cos(PI) > -1.f - 1e-6f && approx::cos(PI) < -1.f + 1e-6f);
+    static_assert(approx::sin(-3.f * PI) > -1e-6f && approx::sin(-3.f * PI) < 1e-6f);
+
+    //transforms
+    static_assert(g_translation * Vector3::one() == Vector3{ 2.f, 3.f, 4.f });
+    static_assert(g_rotation_matrix * Vector3::unit_x() == -Vector3::unit_x());
+    static_assert(translation_from_matrix(create_translation_matrix_34({ 1.f, 2.f, 3.f })) == Vector3{ 1.f, 2.f, 3.f });
+}
\ No newline at end of file
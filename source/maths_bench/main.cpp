@@ -0,0 +1,500 @@
+#include "bench/bench.h"
+
+#include "maths/geometry.h"
+#include "maths/wide.h"
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    //sizes roughly matching a crowd in the launch app, bones per skeleton is limited by the skinning shader
+    constexpr int g_bone_count = 100;
+    constexpr int g_instance_count = 1000;
+    constexpr int g_point_count = 100000;
+    constexpr int g_rotation_count = 100000;
+
+    std::mt19937 g_random(12345);
+
+    float random_float(float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(g_random);
+    }
+
+    geom::Vector3 random_vector()
+    {
+        return { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) };
+    }
+
+    geom::Matrix44 random_transform()
+    {
+        geom::Quaternion rotation = { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f) };
+        return geom::create_translation_matrix_44(random_vector()) * geom::create_rotation_matrix_from_quaternion(rotation.normalized());
+    }
+
+    //the matrix * vector product as it was before the simd kernels, used as the baseline
+    geom::Vector3 transform_point_scalar(const geom::Matrix44& mat, geom::Vector3 vec)
+    {
+        return {
+            mat.get(0, 0) * vec.x + mat.get(0, 1) * vec.y + mat.get(0, 2) * vec.z + mat.get(0, 3),
+            mat.get(1, 0) * vec.x + mat.get(1, 1) * vec.y + mat.get(1, 2) * vec.z + mat.get(1, 3),
+            mat.get(2, 0) * vec.x + mat.get(2, 1) * vec.y + mat.get(2, 2) * vec.z + mat.get(2, 3)
+        };
+    }
+
+    geom::Matrix44 random_affine()
+    {
+        return random_transform() * geom::create_scale_matrix_44({ random_float(0.5f, 2.f), random_float(0.5f, 2.f), random_float(0.5f, 2.f) });
+    }
+
+    geom::Matrix44 random_matrix()
+    {
+        geom::Matrix44 result;
+        for (float& value : result.values)
+        {
+            value = random_float(-1.f, 1.f);
+        }
+        return result;
+    }
+
+    float max_difference(const geom::Matrix44& lhs, const geom::Matrix44& rhs)
+    {
+        float result = 0.f;
+        for (int i = 0; i < 16; ++i)
+        {
+            result = fmaxf(result, fabsf(lhs.values[i] - rhs.values[i]));
+        }
+        return result;
+    }
+
+    //largest element difference from the generic cofactor inverse and of m * inverse from the identity
+    template<typename Invert>
+    void report_inverse_accuracy(const char* name, const std::vector<geom::Matrix44>& matrices, Invert&& invert)
+    {
+        float max_vs_generic = 0.f;
+        float max_vs_identity = 0.f;
+        for (auto& matrix : matrices)
+        {
+            geom::Matrix44 inverse = invert(matrix);
+            max_vs_generic = fmaxf(max_vs_generic, max_difference(inverse, matrix.inverse_generic()));
+            max_vs_identity = fmaxf(max_vs_identity, max_difference(matrix * inverse, geom::Matrix44::identity()));
+        }
+        std::cout << name << " accuracy: max error vs generic " << max_vs_generic << ", max error of m * inverse vs identity " << max_vs_identity << "\n";
+    }
+
+    geom::Quaternion random_rotation(float max_angle)
+    {
+        geom::Vector3 axis = random_vector().normalized();
+        float half_angle = 0.5f * random_float(0.f, max_angle);
+        geom::Vector3 vector_part = axis * sinf(half_angle);
+        return { vector_part.x, vector_part.y, vector_part.z, cosf(half_angle) };
+    }
+
+    //slerp in double precision, the reference every interpolation method is measured against
+    std::array<double, 4> slerp_reference(const geom::Quaternion& q1, const geom::Quaternion& q2, double t)
+    {
+        double cos_theta = (double)q1.x * q2.x + (double)q1.y * q2.y + (double)q1.z * q2.z + (double)q1.w * q2.w;
+        double sign = cos_theta < 0.0 ? -1.0 : 1.0;
+        double theta = std::acos(std::fmin(cos_theta * sign, 1.0));
+        double weight1 = 1.0 - t;
+        double weight2 = t;
+        if (theta > 1e-9)
+        {
+            weight1 = std::sin((1.0 - t) * theta) / std::sin(theta);
+            weight2 = std::sin(t * theta) / std::sin(theta);
+        }
+        weight2 *= sign;
+        return { q1.x * weight1 + q2.x * weight2, q1.y * weight1 + q2.y * weight2, q1.z * weight1 + q2.z * weight2, q1.w * weight1 + q2.w * weight2 };
+    }
+
+    //angle of the rotation between the two orientations, from the chord length so it stays accurate for small angles
+    double angle_between(const std::array<double, 4>& reference, const geom::Quaternion& q)
+    {
+        double dot = reference[0] * q.x + reference[1] * q.y + reference[2] * q.z + reference[3] * q.w;
+        double sign = dot < 0.0 ? -1.0 : 1.0;
+        double chord_squared =
+            std::pow(reference[0] - sign * q.x, 2.0) + std::pow(reference[1] - sign * q.y, 2.0) +
+            std::pow(reference[2] - sign * q.z, 2.0) + std::pow(reference[3] - sign * q.w, 2.0);
+        return 4.0 * std::asin(0.5 * std::sqrt(chord_squared));
+    }
+
+    //pairs of rotations up to max_angle apart, with random signs so the shortest arc handling is exercised
+    struct RotationPairs
+    {
+        std::vector<geom::Quaternion> from;
+        std::vector<geom::Quaternion> to;
+        std::vector<float> t;
+        std::vector<std::array<double, 4>> reference;
+
+        RotationPairs(float max_angle)
+        {
+            from.resize(g_rotation_count);
+            to.resize(g_rotation_count);
+            t.resize(g_rotation_count);
+            reference.resize(g_rotation_count);
+            for (int i = 0; i < g_rotation_count; ++i)
+            {
+                from[i] = random_rotation(geom::PI);
+                to[i] = from[i] * random_rotation(max_angle);
+                if (i % 2 == 1)
+                {
+                    to[i] = to[i] * -1.f;
+                }
+                t[i] = random_float(0.f, 1.f);
+                reference[i] = slerp_reference(from[i], to[i], t[i]);
+            }
+        }
+    };
+
+#if defined(GEOM_SIMD_SSE)
+    //an sse version of geom::simd::multiply_44, it only matches the compiler vectorised plain loop so the library doesn't use it
+    geom::Matrix44 multiply_sse(const geom::Matrix44& matrix_lhs, const geom::Matrix44& matrix_rhs)
+    {
+        const float* lhs = matrix_lhs.values;
+        const float* rhs = matrix_rhs.values;
+        geom::Matrix44 matrix_out;
+        float* out = matrix_out.values;
+
+        //result column = lhs columns weighted by the rhs column's elements
+        __m128 l0 = _mm_load_ps(lhs + 0);
+        __m128 l1 = _mm_load_ps(lhs + 4);
+        __m128 l2 = _mm_load_ps(lhs + 8);
+        __m128 l3 = _mm_load_ps(lhs + 12);
+
+        for (int column = 0; column < 4; ++column)
+        {
+            __m128 r = _mm_load_ps(rhs + column * 4);
+            __m128 result = _mm_mul_ps(l0, _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+            result = _mm_add_ps(result, _mm_mul_ps(l1, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+            result = _mm_add_ps(result, _mm_mul_ps(l2, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2))));
+            result = _mm_add_ps(result, _mm_mul_ps(l3, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+            _mm_store_ps(out + column * 4, result);
+        }
+        return matrix_out;
+    }
+
+    //transforms count points (3 floats each, tightly packed, no alignment requirement) by the affine part of mat
+    //likewise only matches geom::transform_points, see transform_points_kernel below
+    void transform_points_sse(const float* mat, const float* in, float* out, int count)
+    {
+        int i = 0;
+
+        //four points are three registers of interleaved xyz, so instead of deinterleaving them each register is
+        //computed in place with the matrix columns rotated to line up with its lanes
+        //coeff[column][n] holds column rows (n, n + 1, n + 2, n) mod 3
+        __m128 coeff[4][3];
+        for (int column = 0; column < 4; ++column)
+        {
+            __m128 c = _mm_load_ps(mat + column * 4);
+            coeff[column][0] = _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 2, 1, 0));
+            coeff[column][1] = _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 0, 2, 1));
+            coeff[column][2] = _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 1, 0, 2));
+        }
+
+        for (; i + 4 <= count; i += 4)
+        {
+            //a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+            const float* p = in + i * 3;
+            __m128 a = _mm_loadu_ps(p + 0);
+            __m128 b = _mm_loadu_ps(p + 4);
+            __m128 c = _mm_loadu_ps(p + 8);
+
+            //the x, y and z of the point each output lane belongs to
+            __m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+            __m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 y23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+            __m128 x0 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 0, 0));
+            __m128 y0 = _mm_shuffle_ps(y01, y01, _MM_SHUFFLE(2, 0, 0, 0));
+            __m128 z0 = _mm_shuffle_ps(z01, z01, _MM_SHUFFLE(2, 0, 0, 0));
+            __m128 x1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 3, 3));
+            __m128 y1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 0, 0));
+            __m128 z1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 1, 1));
+            __m128 x2 = _mm_shuffle_ps(x23, x23, _MM_SHUFFLE(2, 2, 2, 0));
+            __m128 y2 = _mm_shuffle_ps(y23, y23, _MM_SHUFFLE(2, 2, 2, 0));
+            __m128 z2 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 0));
+
+            float* o = out + i * 3;
+            _mm_storeu_ps(o + 0, _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(coeff[0][0], x0), _mm_mul_ps(coeff[1][0], y0)),
+                _mm_add_ps(_mm_mul_ps(coeff[2][0], z0), coeff[3][0])));
+            _mm_storeu_ps(o + 4, _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(coeff[0][1], x1), _mm_mul_ps(coeff[1][1], y1)),
+                _mm_add_ps(_mm_mul_ps(coeff[2][1], z1), coeff[3][1])));
+            _mm_storeu_ps(o + 8, _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(coeff[0][2], x2), _mm_mul_ps(coeff[1][2], y2)),
+                _mm_add_ps(_mm_mul_ps(coeff[2][2], z2), coeff[3][2])));
+        }
+
+        //remaining points
+        for (; i < count; ++i)
+        {
+            const float* p = in + (size_t)i * 3;
+            float* o = out + (size_t)i * 3;
+            float x = p[0];
+            float y = p[1];
+            float z = p[2];
+            o[0] = mat[0] * x + mat[4] * y + mat[8] * z + mat[12];
+            o[1] = mat[1] * x + mat[5] * y + mat[9] * z + mat[13];
+            o[2] = mat[2] * x + mat[6] * y + mat[10] * z + mat[14];
+        }
+    }
+#endif
+
+    //one matrix stack per instance, each bone's parent is a random earlier bone
+    struct Crowd
+    {
+        std::vector<int> parents;
+        std::vector<geom::Matrix44> locals;
+        std::vector<geom::Matrix44> stacks;
+
+        Crowd()
+        {
+            parents.resize(g_bone_count);
+            locals.resize(g_bone_count);
+            stacks.resize(g_bone_count * g_instance_count);
+            for (int i = 0; i < g_bone_count; ++i)
+            {
+                parents[i] = i == 0 ? -1 : std::uniform_int_distribution<int>(0, i - 1)(g_random);
+                locals[i] = random_transform();
+            }
+        }
+
+        //with a shared stack every instance reuses the first one, which stays in cache, rather than writing out a stack
+        //per instance (6.4MB)
+        template<typename Multiply>
+        void evaluate(Multiply&& multiply, bool shared_stack)
+        {
+            geom::Matrix44* stack = stacks.data();
+            for (int instance = 0; instance < g_instance_count; ++instance)
+            {
+                stack = stacks.data() + (shared_stack ? 0 : instance * g_bone_count);
+                stack[0] = locals[0];
+                for (int i = 1; i < g_bone_count; ++i)
+                {
+                    stack[i] = multiply(stack[parents[i]], locals[i]);
+                }
+                bench::do_not_optimise(stack[g_bone_count - 1]);
+            }
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::parse_options(argc, argv);
+    bench::Report report;
+    report.context["instruction_set"] = geom::simd::instruction_set();
+    std::cout << "instruction set: " << geom::simd::instruction_set() << "\n";
+
+    //matrix stacks
+    Crowd crowd;
+    auto multiply_scalar = [](const geom::Matrix44& lhs, const geom::Matrix44& rhs) { return geom::multiply_scalar(lhs, rhs); };
+    auto multiply_simd = [](const geom::Matrix44& lhs, const geom::Matrix44& rhs) { return lhs * rhs; };
+    auto chain_scalar = bench::run("matrix44_chain_scalar", 10, [&]() { crowd.evaluate(multiply_scalar, true); });
+    auto chain_simd = bench::run("matrix44_chain", 10, [&]() { crowd.evaluate(multiply_simd, true); });
+    auto crowd_scalar = bench::run("matrix44_crowd_scalar", 10, [&]() { crowd.evaluate(multiply_scalar, false); });
+    auto crowd_simd = bench::run("matrix44_crowd", 10, [&]() { crowd.evaluate(multiply_simd, false); });
+    report.add(chain_scalar);
+    report.add(chain_simd);
+    report.add(crowd_scalar);
+    report.add(crowd_simd);
+    bench::print_speedup(chain_scalar, chain_simd);
+    bench::print_speedup(crowd_scalar, crowd_simd);
+#if defined(GEOM_SIMD_SSE)
+    auto chain_sse = bench::run("matrix44_chain_sse", 10, [&]() { crowd.evaluate(multiply_sse, true); });
+    report.add(chain_sse);
+    bench::print_speedup(chain_scalar, chain_sse);
+#endif
+
+    //point transforms
+    geom::Matrix44 transform = random_transform();
+    std::vector<geom::Vector3> points(g_point_count);
+    std::vector<geom::Vector3> transformed(g_point_count);
+    for (auto& point : points)
+    {
+        point = random_vector();
+    }
+
+    auto points_scalar = bench::run("transform_points_scalar", 20, [&]()
+        {
+            for (int i = 0; i < g_point_count; ++i)
+            {
+                transformed[i] = transform_point_scalar(transform, points[i]);
+            }
+            bench::do_not_optimise(transformed.back());
+        });
+    auto points_single = bench::run("transform_points_single", 20, [&]()
+        {
+            for (int i = 0; i < g_point_count; ++i)
+            {
+                transformed[i] = transform * points[i];
+            }
+            bench::do_not_optimise(transformed.back());
+        });
+    auto points_batched = bench::run("transform_points_batched", 20, [&]()
+        {
+            geom::transform_points(transform, points, transformed);
+            bench::do_not_optimise(transformed.back());
+        });
+    report.add(points_scalar);
+    report.add(points_single);
+    report.add(points_batched);
+    bench::print_speedup(points_scalar, points_single);
+    bench::print_speedup(points_scalar, points_batched);
+#if defined(GEOM_SIMD_SSE)
+    //the hand written kernel only matches the compiler vectorised loop, so it stays here rather than in the maths library
+    auto points_kernel = bench::run("transform_points_kernel", 20, [&]()
+        {
+            transform_points_sse(
+                transform.values,
+                reinterpret_cast<const float*>(points.data()),
+                reinterpret_cast<float*>(transformed.data()),
+                g_point_count);
+            bench::do_not_optimise(transformed.back());
+        });
+    report.add(points_kernel);
+    bench::print_speedup(points_scalar, points_kernel);
+#endif
+
+    //inverses, accuracy is measured on matrices suited to each method
+    constexpr int inverse_count = 1000;
+    std::vector<geom::Matrix44> general_matrices(inverse_count);
+    std::vector<geom::Matrix44> affine_matrices(inverse_count);
+    std::vector<geom::Matrix44> rigid_matrices(inverse_count);
+    std::vector<geom::Matrix44> inverses(inverse_count);
+    for (int i = 0; i < inverse_count; ++i)
+    {
+        //avoid near singular matrices so the comparison measures the method rather than the conditioning
+        do
+        {
+            general_matrices[i] = random_matrix();
+        } while (fabsf(general_matrices[i].determinant()) < 0.05f);
+        affine_matrices[i] = random_affine();
+        rigid_matrices[i] = random_transform();
+    }
+
+    report_inverse_accuracy("inverse", general_matrices, [](const geom::Matrix44& m) { return m.inverse(); });
+    report_inverse_accuracy("affine_inverse", affine_matrices, [](const geom::Matrix44& m) { return m.affine_inverse(); });
+    report_inverse_accuracy("rigid_inverse", rigid_matrices, [](const geom::Matrix44& m) { return m.rigid_inverse(); });
+
+    auto time_inverse = [&](const char* name, auto&& invert)
+    {
+        return bench::run(name, 20, [&]()
+            {
+                for (int i = 0; i < inverse_count; ++i)
+                {
+                    inverses[i] = invert(rigid_matrices[i]);
+                }
+                bench::do_not_optimise(inverses.back());
+            });
+    };
+    auto inverse_generic = time_inverse("inverse_generic", [](const geom::Matrix44& m) { return m.inverse_generic(); });
+    auto inverse_closed = time_inverse("inverse", [](const geom::Matrix44& m) { return m.inverse(); });
+    auto inverse_affine = time_inverse("affine_inverse", [](const geom::Matrix44& m) { return m.affine_inverse(); });
+    auto inverse_rigid = time_inverse("rigid_inverse", [](const geom::Matrix44& m) { return m.rigid_inverse(); });
+    report.add(inverse_generic);
+    report.add(inverse_closed);
+    report.add(inverse_affine);
+    report.add(inverse_rigid);
+    bench::print_speedup(inverse_generic, inverse_closed);
+    bench::print_speedup(inverse_generic, inverse_affine);
+    bench::print_speedup(inverse_generic, inverse_rigid);
+
+    //rotation interpolation
+    //error is the largest angle in radians from a double precision slerp, timings are for all g_rotation_count rotations
+    std::string method_names[] = { "slerp", "fast_slerp", "corrected_nlerp", "nlerp" };
+    geom::RotationInterpolation methods[] = {
+        geom::RotationInterpolation::Slerp,
+        geom::RotationInterpolation::FastSlerp,
+        geom::RotationInterpolation::CorrectedNlerp,
+        geom::RotationInterpolation::Nlerp
+    };
+    std::vector<geom::Quaternion> interpolated(g_rotation_count);
+
+    for (float max_angle : { 0.5f, geom::PI })
+    {
+        RotationPairs pairs(max_angle);
+        std::string suffix = max_angle < 1.f ? "_small_angles" : "_any_angles";
+        for (int method = 0; method < 4; ++method)
+        {
+            double scalar_error = 0.0;
+            double wide_error = 0.0;
+            for (int i = 0; i < g_rotation_count; ++i)
+            {
+                geom::Quaternion q = geom::Quaternion::interpolate(pairs.from[i], pairs.to[i], pairs.t[i], methods[method]);
+                scalar_error = std::fmax(scalar_error, angle_between(pairs.reference[i], q));
+            }
+
+            constexpr int width = geom::simd::native_width;
+            using QuaternionxN = geom::QuaternionxN<width>;
+            auto interpolate_wide = [&]()
+            {
+                for (int i = 0; i < g_rotation_count; i += width)
+                {
+                    geom::FloatxN<width> t;
+                    for (int lane = 0; lane < width; ++lane)
+                    {
+                        t.lanes[lane] = pairs.t[i + lane];
+                    }
+                    QuaternionxN::interpolate(QuaternionxN::load(&pairs.from[i]), QuaternionxN::load(&pairs.to[i]), t, methods[method])
+                        .store(&interpolated[i]);
+                }
+                bench::do_not_optimise(interpolated.back());
+            };
+            interpolate_wide();
+            for (int i = 0; i < g_rotation_count; ++i)
+            {
+                wide_error = std::fmax(wide_error, angle_between(pairs.reference[i], interpolated[i]));
+            }
+
+            auto scalar = bench::run(method_names[method] + suffix + "_scalar", 10, [&]()
+                {
+                    for (int i = 0; i < g_rotation_count; ++i)
+                    {
+                        interpolated[i] = geom::Quaternion::interpolate(pairs.from[i], pairs.to[i], pairs.t[i], methods[method]);
+                    }
+                    bench::do_not_optimise(interpolated.back());
+                });
+            auto wide = bench::run(method_names[method] + suffix + "_wide", 10, interpolate_wide);
+            report.add(scalar);
+            report.add(wide);
+
+            std::cout << "  inputs up to " << max_angle << " radians apart, " << method_names[method]
+                << ": scalar error " << scalar_error << ", " << scalar.ns_per_iteration / g_rotation_count << " ns/rotation"
+                << " | wide error " << wide_error << ", " << wide.ns_per_iteration / g_rotation_count << " ns/rotation\n";
+        }
+    }
+
+    //normalisation, as done after every nlerp and when quaternions are read from files
+    std::vector<geom::Quaternion> unnormalised(g_rotation_count);
+    for (auto& q : unnormalised)
+    {
+        q = { random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(0.1f, 1.f) };
+    }
+    auto normalize_scalar = bench::run("quaternion_normalize_scalar", 20, [&]()
+        {
+            for (int i = 0; i < g_rotation_count; ++i)
+            {
+                interpolated[i] = unnormalised[i].normalized();
+            }
+            bench::do_not_optimise(interpolated.back());
+        });
+    auto normalize_wide = bench::run("quaternion_normalize_wide", 20, [&]()
+        {
+            constexpr int width = geom::simd::native_width;
+            for (int i = 0; i < g_rotation_count; i += width)
+            {
+                geom::QuaternionxN<width>::load(&unnormalised[i]).normalized().store(&interpolated[i]);
+            }
+            bench::do_not_optimise(interpolated.back());
+        });
+    report.add(normalize_scalar);
+    report.add(normalize_wide);
+    bench::print_speedup(normalize_scalar, normalize_wide);
+
+    return report.finish(options);
+}
\ No newline at end of file